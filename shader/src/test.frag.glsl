@@ -3,6 +3,9 @@
 #extension GL_GOOGLE_include_directive : enable
 
 #include "device.h"
+#include "specialization.h"
+
+layout(constant_id = SPEC_ID_UV_COLOR) const bool USE_UV_COLOR = true;
 
 layout(location = 0) in vec2 v_uv;
 
@@ -10,5 +13,5 @@ layout(location = 0) out vec4 out_color;
 
 void main()
 {
-    out_color = vec4(v_uv, 1.0, 1.0);
+    out_color = USE_UV_COLOR ? vec4(v_uv, 1.0, 1.0) : vec4(1.0);
 }
\ No newline at end of file
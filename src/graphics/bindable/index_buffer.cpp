@@ -1,10 +1,74 @@
 #include "graphics/bindable/index_buffer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace
+{
+
+// The all-ones index of each type restarts strips, so it is never produced.
+constexpr uint32_t k_max_index8  = 0xfe;
+constexpr uint32_t k_max_index16 = 0xfffe;
+
+// Splits a triangle list into runs of whole triangles whose indices span at most k_max_index16 values, each with its
+// lowest index as vertex offset. Empty if a single triangle spans more.
+template <typename T>
+std::vector<IndexBuffer::Range> split16(std::span<const T> ib)
+{
+    assert(ib.size() % 3 == 0);
+
+    std::vector<IndexBuffer::Range> ranges;
+    uint32_t                        first = 0;
+    uint32_t                        lo    = ~0u;
+    uint32_t                        hi    = 0;
+    for (size_t i = 0; i < ib.size(); i += 3)
+    {
+        const auto     triangle = ib.subspan(i, std::min<size_t>(3, ib.size() - i));
+        const auto     bounds   = std::minmax_element(triangle.begin(), triangle.end());
+        const uint32_t triLo    = *bounds.first;
+        const uint32_t triHi    = *bounds.second;
+        if (triHi - triLo > k_max_index16)
+        {
+            return {};
+        }
+
+        if (std::max(hi, triHi) - std::min(lo, triLo) > k_max_index16)
+        {
+            ranges.push_back({ first, static_cast<uint32_t>(i) - first, static_cast<int32_t>(lo) });
+            first = static_cast<uint32_t>(i);
+            lo    = triLo;
+            hi    = triHi;
+        }
+        lo = std::min(lo, triLo);
+        hi = std::max(hi, triHi);
+    }
+    ranges.push_back({ first, static_cast<uint32_t>(ib.size()) - first, static_cast<int32_t>(lo) });
+    return ranges;
+}
+
+template <typename U, typename T>
+std::vector<U> narrow(std::span<const T> ib, std::span<const IndexBuffer::Range> ranges)
+{
+    std::vector<U> result(ib.size());
+    for (const IndexBuffer::Range& range : ranges)
+    {
+        const uint32_t offset = static_cast<uint32_t>(range.vertex_offset);
+        for (uint32_t i = range.first_index; i < range.first_index + range.count; ++i)
+        {
+            result[i] = static_cast<U>(ib[i] - offset);
+        }
+    }
+    return result;
+}
+
+}  // namespace
 
 template <typename T>
 inline IndexBuffer::IndexBuffer(Graphics& gfx, const T* data, uint32_t count, VkIndexType type)
     : m_size(sizeof(T) * count)
     , m_count(count)
     , m_type(type)
+    , m_ranges{ Range{ 0, count, 0 } }
 {
     create(gfx,
            m_size,
@@ -56,6 +120,44 @@ IndexBuffer::IndexBuffer(Graphics& gfx, std::span<const uint32_t> ib)
     : IndexBuffer(gfx, ib.data(), (uint32_t)ib.size(), VK_INDEX_TYPE_UINT32)
 {}
 
+std::unique_ptr<IndexBuffer> IndexBuffer::createCompact(Graphics& gfx, std::span<const uint16_t> ib)
+{
+    return compact(gfx, ib);
+}
+
+std::unique_ptr<IndexBuffer> IndexBuffer::createCompact(Graphics& gfx, std::span<const uint32_t> ib)
+{
+    return compact(gfx, ib);
+}
+
+template <typename T>
+std::unique_ptr<IndexBuffer> IndexBuffer::compact(Graphics& gfx, std::span<const T> ib)
+{
+    const uint32_t     count    = static_cast<uint32_t>(ib.size());
+    const uint32_t     maxIndex = ib.empty() ? 0 : *std::max_element(ib.begin(), ib.end());
+    std::vector<Range> ranges   = { Range{ 0, count, 0 } };
+
+    if (maxIndex <= k_max_index8 && isIndexTypeUint8Enabled(gfx))
+    {
+        const std::vector<uint8_t> indices = narrow<uint8_t>(ib, ranges);
+        return std::unique_ptr<IndexBuffer>(new IndexBuffer(gfx, indices.data(), count, VK_INDEX_TYPE_UINT8_EXT));
+    }
+    if (maxIndex > k_max_index16)
+    {
+        ranges = split16(ib);
+        if (ranges.empty())
+        {
+            const std::vector<uint32_t> indices(ib.begin(), ib.end());
+            return std::unique_ptr<IndexBuffer>(new IndexBuffer(gfx, indices.data(), count, VK_INDEX_TYPE_UINT32));
+        }
+    }
+
+    const std::vector<uint16_t>  indices = narrow<uint16_t>(ib, ranges);
+    std::unique_ptr<IndexBuffer> buffer(new IndexBuffer(gfx, indices.data(), count, VK_INDEX_TYPE_UINT16));
+    buffer->m_ranges = std::move(ranges);
+    return buffer;
+}
+
 void IndexBuffer::bind_impl(Graphics& gfx) const noexcept
 {
     vkCmdBindIndexBuffer(getCurrSwapchainCmd(gfx), m_buffer, 0, m_type);
@@ -81,4 +183,5 @@ void IndexBuffer::resetToDefault() noexcept
     m_memory = VK_NULL_HANDLE;
     m_count  = 0;
     m_type   = VK_INDEX_TYPE_NONE_KHR;
+    m_ranges.clear();
 }
@@ -1,5 +1,7 @@
 #pragma once
+#include <memory>
 #include <span>
+#include <vector>
 
 #include "graphics/bindable/bindable.h"
 
@@ -10,18 +12,42 @@ class IndexBuffer : public Buffer,
 {
     friend class Bindable<IndexBuffer>;
 
+public:
+    // One draw of the buffer: `count` indices from `first_index`, each added to `vertex_offset`.
+    struct Range
+    {
+        uint32_t first_index   = 0;
+        uint32_t count         = 0;
+        int32_t  vertex_offset = 0;
+    };
+
 public:
     IndexBuffer(Graphics& gfx, std::span<const uint16_t> ib);
     IndexBuffer(Graphics& gfx, std::span<const uint32_t> ib);
     IndexBuffer(const IndexBuffer&)            = delete;
     IndexBuffer& operator=(const IndexBuffer&) = delete;
 
+    // Stores a triangle list with the narrowest index type its values fit: 8-bit when the device supports it, else
+    // 16-bit. Meshes with more vertices are split into ranges of whole triangles that each span fewer than 65535
+    // vertices and are drawn with their lowest index as vertex offset, which works best on vertex fetch optimized
+    // meshes; 32-bit indices remain for the triangles that cannot be split that way. The all-ones values are left
+    // free for primitive restart.
+    static std::unique_ptr<IndexBuffer> createCompact(Graphics& gfx, std::span<const uint16_t> ib);
+    static std::unique_ptr<IndexBuffer> createCompact(Graphics& gfx, std::span<const uint32_t> ib);
+
 private:
     template <typename T>
     IndexBuffer(Graphics& gfx, const T* data, uint32_t count, VkIndexType type);
 
+    template <typename T>
+    static std::unique_ptr<IndexBuffer> compact(Graphics& gfx, std::span<const T> ib);
+
 public:
-    uint32_t getCount() const { return m_count; }
+    uint32_t    getCount() const { return m_count; }
+    VkIndexType getType() const { return m_type; }
+
+    // Draws to issue after binding, a single range over the whole buffer unless createCompact() split it.
+    std::span<const Range> getRanges() const { return m_ranges; }
 
 private:
     void bind_impl(Graphics& gfx) const noexcept;
@@ -35,4 +61,6 @@ protected:
     VkDeviceMemory m_memory = VK_NULL_HANDLE;
     uint32_t       m_count  = 0;
     VkIndexType    m_type   = VK_INDEX_TYPE_NONE_KHR;
+
+    std::vector<Range> m_ranges;
 };
@@ -0,0 +1,23 @@
+#include "graphics/bindable/instance_buffer.h"
+
+InstanceBuffer::InstanceBuffer(Graphics& gfx, const vertex::Buffer& instances, uint32_t first_binding)
+    : m_streams(gfx, instances)
+    , m_first_binding(first_binding)
+    , m_count(static_cast<uint32_t>(instances.count()))
+{
+    for (uint32_t stream = 0; stream < instances.streamCount(); ++stream)
+    {
+        assert(instances.layout().getInputRate(stream) == VK_VERTEX_INPUT_RATE_INSTANCE && "Instance streams step per instance.");
+    }
+}
+
+void InstanceBuffer::bind_impl(Graphics& gfx) const noexcept
+{
+    m_streams.bindStreams(gfx, m_first_binding);
+}
+
+void InstanceBuffer::destroy_impl(Graphics& gfx) noexcept
+{
+    m_streams.destroy(gfx);
+    m_count = 0;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "graphics/bindable/vertex_buffer.h"
+
+// Per-instance attributes, e.g. the AttributeType::InstanceRow0 to InstanceRow2 transform of each copy of a mesh, from
+// a vertex::Buffer whose streams are all appended with VK_VERTEX_INPUT_RATE_INSTANCE. Its streams are bound after the
+// vertex streams, so the pipeline describes the two layouts one after the other:
+//
+//     vertexLayout.getAttributeDescs(0, attribute_descs);
+//     instanceLayout.getAttributeDescs(vertexLayout.getStreamCount(), attribute_descs, vertexLayout.getElementCount());
+//     vertexLayout.getBindingDescs(0, binding_descs);
+//     instanceLayout.getBindingDescs(vertexLayout.getStreamCount(), binding_descs);
+class InstanceBuffer : public Bindable<InstanceBuffer>
+{
+    friend class Bindable<InstanceBuffer>;
+
+public:
+    // Stream i of `instances` is bound on binding `first_binding + i`.
+    InstanceBuffer(Graphics& gfx, const vertex::Buffer& instances, uint32_t first_binding);
+    InstanceBuffer(const InstanceBuffer&)            = delete;
+    InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+
+    uint32_t getCount() const noexcept { return m_count; }
+    uint32_t getFirstBinding() const noexcept { return m_first_binding; }
+
+private:
+    void bind_impl(Graphics& gfx) const noexcept;
+    void destroy_impl(Graphics& gfx) noexcept;
+
+protected:
+    VertexBuffer m_streams;  // Uploaded like vertices, only the input rate of the pipeline differs.
+    uint32_t     m_first_binding = 0;
+    uint32_t     m_count         = 0;
+};
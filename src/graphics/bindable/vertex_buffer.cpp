@@ -1,14 +1,43 @@
 #include "graphics/bindable/vertex_buffer.h"
+#include <cstring>
+
+namespace
+{
+// Keeps every attribute of a stream aligned to its format, whatever the size of the streams before it.
+constexpr VkDeviceSize k_stream_alignment = 16;
+}  // namespace
 
 VertexBuffer::VertexBuffer(Graphics& gfx, const vertex::Buffer& vb)
-    : m_size((VkDeviceSize)vb.sizeOf())
 {
+    std::vector<std::span<const std::byte>> streams;
+    for (uint32_t stream = 0; stream < vb.streamCount(); ++stream)
+    {
+        streams.push_back(vb.data(stream));
+    }
+    upload(gfx, streams);
+}
+
+VertexBuffer::VertexBuffer(Graphics& gfx, std::span<const std::byte> data)
+{
+    upload(gfx, { &data, 1 });
+}
+
+void VertexBuffer::upload(Graphics& gfx, std::span<const std::span<const std::byte>> streams)
+{
+    for (std::span<const std::byte> stream : streams)
+    {
+        m_size = (m_size + k_stream_alignment - 1) / k_stream_alignment * k_stream_alignment;
+        m_offsets.push_back(m_size);
+        m_size += stream.size();
+    }
+
     create(gfx,
            m_size,
            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
            m_buffer,
            m_memory);
+    m_buffers.assign(streams.size(), m_buffer);
 
 
     VkBuffer       staging_buffer = {};
@@ -24,7 +53,10 @@ VertexBuffer::VertexBuffer(Graphics& gfx, const vertex::Buffer& vb)
 
         {
             Mapper<std::byte> map(gfx, staging_memory, m_size, 0);
-            std::memcpy(&map, vb.dataPtr(), m_size);
+            for (size_t i = 0; i < streams.size(); ++i)
+            {
+                std::memcpy(&map + m_offsets[i], streams[i].data(), streams[i].size());
+            }
         }
 
         Buffer::copy(gfx, staging_buffer, m_buffer, m_size);
@@ -45,9 +77,19 @@ VertexBuffer::VertexBuffer(Graphics& gfx, const vertex::Buffer& vb)
     }
 }
 
+void VertexBuffer::bindStream(Graphics& gfx, uint32_t stream, uint32_t binding) const noexcept
+{
+    vkCmdBindVertexBuffers(getCurrSwapchainCmd(gfx), binding, 1, &m_buffer, &m_offsets[stream]);
+}
+
+void VertexBuffer::bindStreams(Graphics& gfx, uint32_t first_binding) const noexcept
+{
+    vkCmdBindVertexBuffers(getCurrSwapchainCmd(gfx), first_binding, (uint32_t)m_buffers.size(), m_buffers.data(), m_offsets.data());
+}
+
 void VertexBuffer::bind_impl(Graphics& gfx) const noexcept
 {
-    vkCmdBindVertexBuffers(getCurrSwapchainCmd(gfx), 0, 1, &m_buffer, &m_offset);
+    bindStreams(gfx, 0);
 }
 
 void VertexBuffer::destroy_impl(Graphics& gfx) noexcept
@@ -67,6 +109,7 @@ void VertexBuffer::resetToDefault() noexcept
 {
     m_size   = 0;
     m_buffer = VK_NULL_HANDLE;
-    m_offset = 0;
     m_memory = VK_NULL_HANDLE;
+    m_offsets.clear();
+    m_buffers.clear();
 }
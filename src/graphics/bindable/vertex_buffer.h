@@ -12,20 +12,33 @@ class VertexBuffer : public Buffer,
     friend class Bindable<VertexBuffer>;
 
 public:
+    // One binding per stream of the layout, from binding 0, all in the same VkBuffer.
     VertexBuffer(Graphics& gfx, const vertex::Buffer& vb);
+    // Vertices laid out by the caller, e.g. a std::vector<vertex::StaticLayout<...>::Vertex> passed through std::as_bytes.
+    VertexBuffer(Graphics& gfx, std::span<const std::byte> data);
     VertexBuffer(const VertexBuffer&)            = delete;
     VertexBuffer& operator=(const VertexBuffer&) = delete;
     virtual ~VertexBuffer() noexcept             = default;
 
+    // Binds a single stream, e.g. the positions for a depth-only pass whose pipeline only has that binding.
+    void bindStream(Graphics& gfx, uint32_t stream, uint32_t binding) const noexcept;
+    // Binds every stream, stream i on binding `first_binding + i`.
+    void bindStreams(Graphics& gfx, uint32_t first_binding) const noexcept;
+
+    uint32_t getStreamCount() const noexcept { return static_cast<uint32_t>(m_offsets.size()); }
+
 private:
+    void upload(Graphics& gfx, std::span<const std::span<const std::byte>> streams);
+
     void bind_impl(Graphics& gfx) const noexcept;
     void destroy_impl(Graphics& gfx) noexcept;
 
     void resetToDefault() noexcept;
 
 protected:
-    VkDeviceSize   m_size   = 0;
-    VkBuffer       m_buffer = VK_NULL_HANDLE;
-    VkDeviceMemory m_memory = VK_NULL_HANDLE;
-    VkDeviceSize   m_offset = 0;
+    VkDeviceSize              m_size   = 0;
+    VkBuffer                  m_buffer = VK_NULL_HANDLE;
+    VkDeviceMemory            m_memory = VK_NULL_HANDLE;
+    std::vector<VkDeviceSize> m_offsets;  // Of each stream in m_buffer.
+    std::vector<VkBuffer>     m_buffers;  // m_buffer once per stream, for vkCmdBindVertexBuffers.
 };
@@ -10,7 +10,16 @@ void Drawable::draw(Graphics& gfx) const noexcept
     {
         m_index_buffer->bind(gfx);
     }
-    gfx.drawIndexed(m_index_buffer->getCount());
+    if (m_instance_buffer)
+    {
+        m_instance_buffer->bind(gfx);
+    }
+
+    const uint32_t instance_count = m_instance_buffer ? m_instance_buffer->getCount() : 1;
+    for (const IndexBuffer::Range& range : m_index_buffer->getRanges())
+    {
+        gfx.drawIndexedInstanced(range.count, instance_count, range.first_index, range.vertex_offset);
+    }
 }
 
 void Drawable::destroy(Graphics& gfx) noexcept
@@ -25,6 +34,11 @@ void Drawable::destroy(Graphics& gfx) noexcept
         m_index_buffer->destroy(gfx);
         m_index_buffer.reset();
     }
+    if (m_instance_buffer)
+    {
+        m_instance_buffer->destroy(gfx);
+        m_instance_buffer.reset();
+    }
 }
 
 void Drawable::setVertexBuffer(std::unique_ptr<VertexBuffer> vb) noexcept
@@ -36,3 +50,8 @@ void Drawable::setIndexBuffer(std::unique_ptr<IndexBuffer> ib) noexcept
 {
     m_index_buffer = std::move(ib);
 }
+
+void Drawable::setInstanceBuffer(std::unique_ptr<InstanceBuffer> instances) noexcept
+{
+    m_instance_buffer = std::move(instances);
+}
@@ -10,6 +10,7 @@
 
 #include "graphics/bindable/vertex_buffer.h"
 #include "graphics/bindable/index_buffer.h"
+#include "graphics/bindable/instance_buffer.h"
 
 class Drawable
 {
@@ -30,8 +31,11 @@ public:
 protected:
     void setVertexBuffer(std::unique_ptr<VertexBuffer> vb) noexcept;
     void setIndexBuffer(std::unique_ptr<IndexBuffer> ib) noexcept;
+    // Draws one copy per instance in a single call; without one the drawable is drawn once.
+    void setInstanceBuffer(std::unique_ptr<InstanceBuffer> instances) noexcept;
 
 private:
-    std::unique_ptr<VertexBuffer> m_vertex_buffer;
-    std::unique_ptr<IndexBuffer>  m_index_buffer;
+    std::unique_ptr<VertexBuffer>   m_vertex_buffer;
+    std::unique_ptr<IndexBuffer>    m_index_buffer;
+    std::unique_ptr<InstanceBuffer> m_instance_buffer;
 };
@@ -1,4 +1,5 @@
 #include "graphics/graphics.h"
+#include <filesystem>
 #include <set>
 #include <sstream>
 #include <string>
@@ -28,13 +29,24 @@
 #include "graphics/graphics_throw_macros.h"
 
 #include "shader_header/device.h"
+#include "shader_header/specialization.h"
 #include "shader_header/vertex_info.h"
 
+#include "graphics/shader_hot_reload.h"
 #include "graphics/vertex.h"
 
 #include "graphics/resource/uniform_buffer.h"
 
+#include "graphics/vulkan_helper/barrier_helper.h"
 #include "graphics/vulkan_helper/pipeline_helper.h"
+#include "graphics/vulkan_helper/pipeline_cache_helper.h"
+#include "graphics/vulkan_helper/pipeline_state_cache.h"
+#include "graphics/vulkan_helper/pipeline_compiler.h"
+#include "graphics/vulkan_helper/pipeline_library_cache.h"
+#include "graphics/vulkan_helper/dynamic_state_recorder.h"
+#include "graphics/vulkan_helper/shader_library.h"
+#include "graphics/vulkan_helper/specialization_constants.h"
+#include "graphics/vulkan_helper/shader_reflection.h"
 #include "graphics/vulkan_helper/descriptorsets_helper.h"
 
 #include "graphics/drawable/box.h"
@@ -132,6 +144,18 @@ std::vector<VkExtensionProperties> enumerateDeviceExtensionProperties(VkPhysical
     return props;
 }
 
+bool hasExtension(const std::vector<VkExtensionProperties>& props, const char* name)
+{
+    for (const auto& prop : props)
+    {
+        if (std::strcmp(name, prop.extensionName) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 std::vector<VkSurfaceFormatKHR> getSurfaceFormatsKHR(VkPhysicalDevice gpu, VkSurfaceKHR surface)
 {
     uint32_t count = 0;
@@ -160,6 +184,27 @@ std::vector<VkPresentModeKHR> getSurfacePresentModesKHR(VkPhysicalDevice gpu, Vk
 }  // namespace
 #endif  // USE_VULKAN_VALIDATION_LAYER
 
+namespace
+{
+// Shared between C++ and GLSL, relative to the run directory.
+constexpr const char* k_shader_include_dir = "src/shader_header";
+
+// Specialization constants of the test shaders.
+constexpr vulkan::SpecializationConstant<bool> k_spec_uv_color{ SPEC_ID_UV_COLOR };
+
+// The pipeline cache lives next to the compiled shaders, e.g. "shader/pipeline_cache.bin".
+std::filesystem::path getPipelineCachePath()
+{
+    return std::filesystem::path(getShaderSearchPath()).parent_path() / "pipeline_cache.bin";
+}
+
+// GLSL sources, e.g. "shader/src". Only present in a development checkout.
+std::filesystem::path getShaderSourcePath()
+{
+    return std::filesystem::path(getShaderSearchPath()).parent_path() / "src";
+}
+}  // namespace
+
 Graphics::Graphics(Window& window)
     : m_window(window)
 {
@@ -276,7 +321,8 @@ Graphics::Graphics(Window& window)
         uint32_t queue_family_idx = 0;
         for (const auto& prop : queue_props)
         {
-            if (prop.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+            // Compute passes are recorded in the same command buffers as the draws.
+            if ((prop.queueFlags & VK_QUEUE_GRAPHICS_BIT) && (prop.queueFlags & VK_QUEUE_COMPUTE_BIT))
             {
                 m_queue_family_index_graphics = queue_family_idx;
             }
@@ -313,22 +359,15 @@ Graphics::Graphics(Window& window)
             }
         }
 
+        auto available_device_extensions = enumerateDeviceExtensionProperties(m_active_gpu);
+
         std::vector<const char*> device_extensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
         {
             std::vector<const char*> not_found_extensions;
 
-            auto available_device_extensions = enumerateDeviceExtensionProperties(m_active_gpu);
             for (const char* const extension : device_extensions)
             {
-                bool found = false;
-                for (const auto& prop : available_device_extensions)
-                {
-                    if (std::strcmp(extension, prop.extensionName) == 0)
-                    {
-                        found = true;
-                    }
-                }
-                if (!found)
+                if (!hasExtension(available_device_extensions, extension))
                 {
                     not_found_extensions.push_back(extension);
                 }
@@ -347,10 +386,117 @@ Graphics::Graphics(Window& window)
             }
         }
 
-        VkPhysicalDeviceFeatures device_features = { .samplerAnisotropy = VK_TRUE };
+        // Optional: graphics pipeline libraries, only worth it when the driver links them fast.
+        VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT gpl_features = {
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT
+        };
+        gpl_features.pNext = nullptr;
+        if (hasExtension(available_device_extensions, VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+            hasExtension(available_device_extensions, VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME))
+        {
+            VkPhysicalDeviceFeatures2 supported_features = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
+            supported_features.pNext                     = &gpl_features;
+            vkGetPhysicalDeviceFeatures2(m_active_gpu, &supported_features);
+
+            VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT gpl_props = {
+                VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT
+            };
+            gpl_props.pNext = nullptr;
+
+            VkPhysicalDeviceProperties2 props = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2 };
+            props.pNext                       = &gpl_props;
+            vkGetPhysicalDeviceProperties2(m_active_gpu, &props);
+
+            m_graphics_pipeline_library_enabled = gpl_features.graphicsPipelineLibrary && gpl_props.graphicsPipelineLibraryFastLinking;
+        }
+        gpl_features.graphicsPipelineLibrary = m_graphics_pipeline_library_enabled ? VK_TRUE : VK_FALSE;
+        if (m_graphics_pipeline_library_enabled)
+        {
+            device_extensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+            device_extensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+        }
+        LogInfo("Graphics pipeline library: {}.", m_graphics_pipeline_library_enabled ? "enabled" : "not available");
+
+        // Optional: the fixed-function states of VK_EXT_extended_dynamic_state3 that GraphicsPipelineState makes dynamic.
+        // Extended dynamic state 1 and 2 are core in Vulkan 1.3.
+        VkPhysicalDeviceExtendedDynamicState3FeaturesEXT eds3_features = {
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT
+        };
+        eds3_features.pNext = nullptr;
+        if (hasExtension(available_device_extensions, VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME))
+        {
+            VkPhysicalDeviceFeatures2 supported_features = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
+            supported_features.pNext                     = &eds3_features;
+            vkGetPhysicalDeviceFeatures2(m_active_gpu, &supported_features);
+
+            m_extended_dynamic_state3_enabled = eds3_features.extendedDynamicState3PolygonMode &&
+                                                eds3_features.extendedDynamicState3DepthClampEnable &&
+                                                eds3_features.extendedDynamicState3LogicOpEnable &&
+                                                eds3_features.extendedDynamicState3ColorBlendEnable &&
+                                                eds3_features.extendedDynamicState3ColorBlendEquation &&
+                                                eds3_features.extendedDynamicState3ColorWriteMask;
+        }
+        if (m_extended_dynamic_state3_enabled)
+        {
+            // Only the states the engine uses, the others may be slower on some drivers.
+            VkPhysicalDeviceExtendedDynamicState3FeaturesEXT enabled = {
+                VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT
+            };
+            enabled.pNext                                   = nullptr;
+            enabled.extendedDynamicState3PolygonMode        = VK_TRUE;
+            enabled.extendedDynamicState3DepthClampEnable   = VK_TRUE;
+            enabled.extendedDynamicState3LogicOpEnable      = VK_TRUE;
+            enabled.extendedDynamicState3ColorBlendEnable   = VK_TRUE;
+            enabled.extendedDynamicState3ColorBlendEquation = VK_TRUE;
+            enabled.extendedDynamicState3ColorWriteMask     = VK_TRUE;
+            eds3_features                                   = enabled;
+
+            device_extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+        }
+        LogInfo("Extended dynamic state 3: {}.", m_extended_dynamic_state3_enabled ? "enabled" : "not available");
+
+        // Optional: 8-bit indices, IndexBuffer::createCompact() falls back to 16-bit without them.
+        VkPhysicalDeviceIndexTypeUint8FeaturesEXT index_uint8_features = {
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_INDEX_TYPE_UINT8_FEATURES_EXT
+        };
+        index_uint8_features.pNext = nullptr;
+        if (hasExtension(available_device_extensions, VK_EXT_INDEX_TYPE_UINT8_EXTENSION_NAME))
+        {
+            VkPhysicalDeviceFeatures2 supported_features = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
+            supported_features.pNext                     = &index_uint8_features;
+            vkGetPhysicalDeviceFeatures2(m_active_gpu, &supported_features);
+
+            m_index_type_uint8_enabled = index_uint8_features.indexTypeUint8;
+        }
+        if (m_index_type_uint8_enabled)
+        {
+            device_extensions.push_back(VK_EXT_INDEX_TYPE_UINT8_EXTENSION_NAME);
+        }
+        LogInfo("8-bit index type: {}.", m_index_type_uint8_enabled ? "enabled" : "not available");
+
+        void* feature_chain = nullptr;
+        if (m_graphics_pipeline_library_enabled)
+        {
+            gpl_features.pNext = feature_chain;
+            feature_chain      = &gpl_features;
+        }
+        if (m_extended_dynamic_state3_enabled)
+        {
+            eds3_features.pNext = feature_chain;
+            feature_chain       = &eds3_features;
+        }
+        if (m_index_type_uint8_enabled)
+        {
+            index_uint8_features.pNext = feature_chain;
+            feature_chain              = &index_uint8_features;
+        }
+
+        VkPhysicalDeviceFeatures2 device_features  = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
+        device_features.pNext                      = feature_chain;
+        device_features.features.samplerAnisotropy = VK_TRUE;
 
         VkDeviceCreateInfo device_info      = { VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
-        device_info.pNext                   = nullptr;
+        device_info.pNext                   = &device_features;
         device_info.flags                   = 0;
         device_info.queueCreateInfoCount    = static_cast<uint32_t>(queue_infos.size());
         device_info.pQueueCreateInfos       = queue_infos.data();
@@ -358,13 +504,37 @@ Graphics::Graphics(Window& window)
         device_info.ppEnabledLayerNames     = nullptr;  // deprecated
         device_info.enabledExtensionCount   = static_cast<uint32_t>(device_extensions.size());
         device_info.ppEnabledExtensionNames = device_extensions.empty() ? nullptr : device_extensions.data();
-        device_info.pEnabledFeatures        = &device_features;
+        device_info.pEnabledFeatures        = nullptr;  // enabled through device_features
 
         VK_EXCEPT(vkCreateDevice(m_active_gpu, &device_info, nullptr, &m_device));
 
 
         vkGetDeviceQueue(m_device, m_queue_family_index_graphics, 0, &m_queue_graphics);
         vkGetDeviceQueue(m_device, m_queue_family_index_present, 0, &m_queue_present);
+
+        m_dynamic_state  = std::make_unique<vulkan::DynamicStateRecorder>(m_device, m_extended_dynamic_state3_enabled);
+        m_shader_library = std::make_unique<vulkan::ShaderLibrary>(m_device, k_max_in_flight_count);
+    }
+
+    {
+        m_pipeline_cache    = vulkan::loadPipelineCache(m_device, m_active_gpu, getPipelineCachePath());
+        m_pso_cache         = std::make_unique<vulkan::PipelineStateCache>(m_device, k_max_in_flight_count);
+        m_pipeline_compiler = std::make_unique<vulkan::PipelineCompiler>(m_device, *m_pso_cache);
+        if (m_graphics_pipeline_library_enabled)
+        {
+            m_pipeline_libraries = std::make_unique<vulkan::PipelineLibraryCache>(m_device, m_pipeline_cache);
+            m_pipeline_compiler->setLibraryCache(m_pipeline_libraries.get());
+        }
+
+        if (std::filesystem::is_directory(getShaderSourcePath()))
+        {
+            m_pipeline_compiler->setKeepGenerators(true);
+            m_shader_hot_reload = std::make_unique<ShaderHotReload>(*m_shader_library,
+                                                                    *m_pipeline_compiler,
+                                                                    getShaderSourcePath(),
+                                                                    getShaderSearchPath(),
+                                                                    std::vector<std::filesystem::path>{ k_shader_include_dir });
+        }
     }
 
     {
@@ -464,6 +634,71 @@ Graphics::Graphics(Window& window)
         }
     }
 
+    {
+        std::vector<VkAttachmentDescription> allAttachments;
+        std::vector<VkAttachmentReference>   color_attachment_refs;
+
+        VkAttachmentDescription attachment = {};
+        attachment.format                  = (VkFormat)m_swapchain_surface_format.format;
+        attachment.samples                 = VK_SAMPLE_COUNT_1_BIT;
+        attachment.loadOp                  = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        attachment.storeOp                 = VK_ATTACHMENT_STORE_OP_STORE;
+        attachment.stencilLoadOp           = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachment.stencilStoreOp          = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachment.initialLayout           = VK_IMAGE_LAYOUT_UNDEFINED;
+        attachment.finalLayout             = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+        VkAttachmentReference attachment_ref = {};
+        attachment_ref.attachment            = static_cast<uint32_t>(allAttachments.size());
+        attachment_ref.layout                = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        allAttachments.push_back(attachment);
+        color_attachment_refs.push_back(attachment_ref);
+
+
+        std::vector<VkSubpassDescription> subpasses;
+        std::vector<VkSubpassDependency>  subpassDependencies;
+
+        for (uint32_t i = 0; i < 1; i++)
+        {
+            VkSubpassDescription subpass    = {};
+            subpass.flags                   = 0;
+            subpass.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
+            subpass.inputAttachmentCount    = 0;
+            subpass.pInputAttachments       = nullptr;
+            subpass.colorAttachmentCount    = static_cast<uint32_t>(color_attachment_refs.size());
+            subpass.pColorAttachments       = color_attachment_refs.data();
+            subpass.pResolveAttachments     = nullptr;
+            subpass.pDepthStencilAttachment = nullptr;
+            subpass.preserveAttachmentCount = 0;
+            subpass.pPreserveAttachments    = nullptr;
+
+            VkSubpassDependency dependency  = {};
+            dependency.srcSubpass           = i == 0 ? (VK_SUBPASS_EXTERNAL) : (i - 1);
+            dependency.dstSubpass           = i;
+            dependency.srcStageMask         = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            dependency.dstStageMask         = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            dependency.srcAccessMask        = 0;
+            dependency.dstAccessMask        = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            dependency.srcStageMask        |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+            dependency.dstStageMask        |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+            dependency.dstAccessMask       |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+            subpasses.push_back(subpass);
+            subpassDependencies.push_back(dependency);
+        }
+
+        VkRenderPassCreateInfo render_pass_info = { VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO };
+        render_pass_info.attachmentCount        = static_cast<uint32_t>(allAttachments.size());
+        render_pass_info.pAttachments           = allAttachments.data();
+        render_pass_info.subpassCount           = static_cast<uint32_t>(subpasses.size());
+        render_pass_info.pSubpasses             = subpasses.data();
+        render_pass_info.dependencyCount        = static_cast<uint32_t>(subpassDependencies.size());
+        render_pass_info.pDependencies          = subpassDependencies.data();
+
+        VK_EXCEPT(vkCreateRenderPass(m_device, &render_pass_info, nullptr, &m_render_pass));
+    }
+
     {
         VkCommandPoolCreateInfo pool_info = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
         pool_info.pNext                   = nullptr;
@@ -503,10 +738,56 @@ Graphics::Graphics(Window& window)
             VK_EXCEPT(vkCreateFence(m_device, &fence_info, nullptr, &m_cmd_available_fences[i]));
         }
     }
+
+    {
+        // Layouts are derived from the shaders once; stages or vertex attributes that disagree throw here, not while drawing.
+        vulkan::ShaderReflection reflection = m_shader_library->get("test.vert.spv").reflection;
+        reflection.merge(m_shader_library->get("test.frag.spv").reflection);
+
+        const uint32_t binding = 0;
+
+        // Positions get their own stream, so passes that only need them fetch a third of the data.
+        m_test_layout = std::make_unique<vertex::Layout>();
+        m_test_layout->append(vertex::AttributeType::Pos3d, 0);
+        m_test_layout->append(vertex::AttributeType::TexCoords, 1);
+
+        std::vector<VkVertexInputAttributeDescription> attribute_descs;
+        std::vector<VkVertexInputBindingDescription>   binding_descs;
+        m_test_layout->getAttributeDescs(binding, attribute_descs);
+        m_test_layout->getBindingDescs(binding, binding_descs);
+        reflection.validateVertexInput(attribute_descs);
+
+        m_test_pipeline_state                              = std::make_unique<vulkan::GraphicsPipelineState>();
+        m_test_pipeline_state->rasterizationState.cullMode = VK_CULL_MODE_BACK_BIT;
+        m_test_pipeline_state->addExtendedDynamicStates(m_extended_dynamic_state3_enabled);
+        m_test_pipeline_state->addBindingDescriptions(binding_descs);
+        m_test_pipeline_state->addAttributeDescriptions(attribute_descs);
+
+        m_test_dset = std::make_unique<vulkan::DescriptorSetContainer>(m_device);
+        for (const VkDescriptorSetLayoutBinding& layout_binding : reflection.getSetLayoutBindings(0))
+        {
+            m_test_dset->addBinding(layout_binding);
+        }
+        m_test_dset->initLayout();
+        m_test_dset->initPool(k_max_in_flight_count);
+        m_test_dset->initPipeLayout(static_cast<uint32_t>(reflection.pushConstantRanges.size()),
+                                    reflection.pushConstantRanges.empty() ? nullptr : reflection.pushConstantRanges.data());
+    }
 }
 
 Graphics::~Graphics() noexcept
 {
+    // Joins the workers first: queued jobs still reference the render pass and pipeline layout.
+    m_shader_hot_reload.reset();
+    m_pipeline_compiler.reset();
+    m_test_dset.reset();
+
+    if (m_render_pass != VK_NULL_HANDLE)
+    {
+        vkDestroyRenderPass(m_device, m_render_pass, nullptr);
+        m_render_pass = VK_NULL_HANDLE;
+    }
+
     for (VkSemaphore s : m_swapchain_render_finished_semaphores)
     {
         if (s != VK_NULL_HANDLE)
@@ -532,6 +813,17 @@ Graphics::~Graphics() noexcept
     }
     m_cmd_available_fences.clear();
 
+    m_pso_cache.reset();
+    m_pipeline_libraries.reset();
+    m_shader_library.reset();
+
+    if (m_pipeline_cache != VK_NULL_HANDLE)
+    {
+        vulkan::savePipelineCache(m_device, m_active_gpu, m_pipeline_cache, getPipelineCachePath());
+        vkDestroyPipelineCache(m_device, m_pipeline_cache, nullptr);
+        m_pipeline_cache = VK_NULL_HANDLE;
+    }
+
     if (m_swapchain_image_present_cmd_pool != VK_NULL_HANDLE)
     {
         vkFreeCommandBuffers(m_device, m_swapchain_image_present_cmd_pool, m_swapchain_image_count, m_swapchain_image_present_cmds.data());
@@ -598,6 +890,19 @@ void Graphics::beginFrame()
                                     &m_curr_sc_img_index));
 
     VK_EXCEPT(vkResetCommandBuffer(cmd, VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT));
+
+    // Pipelines finished in the background become visible at the frame boundary.
+    m_pso_cache->nextFrame();
+    if (m_pipeline_compiler->getPendingCount() == 0)
+    {
+        // Background jobs may still be compiling from a replaced shader module.
+        m_shader_library->nextFrame();
+    }
+    if (m_shader_hot_reload)
+    {
+        m_shader_hot_reload->update();
+    }
+    m_pipeline_compiler->collect();
 }
 
 void Graphics::endFrame()
@@ -618,72 +923,6 @@ void Graphics::endFrame()
 
 void Graphics::drawTestData()
 {
-    VkRenderPass render_pass = VK_NULL_HANDLE;
-    {
-        std::vector<VkAttachmentDescription> allAttachments;
-        std::vector<VkAttachmentReference>   color_attachment_refs;
-
-        VkAttachmentDescription attachment = {};
-        attachment.format                  = (VkFormat)m_swapchain_surface_format.format;
-        attachment.samples                 = VK_SAMPLE_COUNT_1_BIT;
-        attachment.loadOp                  = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        attachment.storeOp                 = VK_ATTACHMENT_STORE_OP_STORE;
-        attachment.stencilLoadOp           = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        attachment.stencilStoreOp          = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        attachment.initialLayout           = VK_IMAGE_LAYOUT_UNDEFINED;
-        attachment.finalLayout             = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-        VkAttachmentReference attachment_ref = {};
-        attachment_ref.attachment            = static_cast<uint32_t>(allAttachments.size());
-        attachment_ref.layout                = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-        allAttachments.push_back(attachment);
-        color_attachment_refs.push_back(attachment_ref);
-
-
-        std::vector<VkSubpassDescription> subpasses;
-        std::vector<VkSubpassDependency>  subpassDependencies;
-
-        for (uint32_t i = 0; i < 1; i++)
-        {
-            VkSubpassDescription subpass    = {};
-            subpass.flags                   = 0;
-            subpass.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
-            subpass.inputAttachmentCount    = 0;
-            subpass.pInputAttachments       = nullptr;
-            subpass.colorAttachmentCount    = static_cast<uint32_t>(color_attachment_refs.size());
-            subpass.pColorAttachments       = color_attachment_refs.data();
-            subpass.pResolveAttachments     = nullptr;
-            subpass.pDepthStencilAttachment = nullptr;
-            subpass.preserveAttachmentCount = 0;
-            subpass.pPreserveAttachments    = nullptr;
-
-            VkSubpassDependency dependency  = {};
-            dependency.srcSubpass           = i == 0 ? (VK_SUBPASS_EXTERNAL) : (i - 1);
-            dependency.dstSubpass           = i;
-            dependency.srcStageMask         = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-            dependency.dstStageMask         = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-            dependency.srcAccessMask        = 0;
-            dependency.dstAccessMask        = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-            dependency.srcStageMask        |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-            dependency.dstStageMask        |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-            dependency.dstAccessMask       |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-
-            subpasses.push_back(subpass);
-            subpassDependencies.push_back(dependency);
-        }
-
-        VkRenderPassCreateInfo render_pass_info = { VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO };
-        render_pass_info.attachmentCount        = static_cast<uint32_t>(allAttachments.size());
-        render_pass_info.pAttachments           = allAttachments.data();
-        render_pass_info.subpassCount           = static_cast<uint32_t>(subpasses.size());
-        render_pass_info.pSubpasses             = subpasses.data();
-        render_pass_info.dependencyCount        = static_cast<uint32_t>(subpassDependencies.size());
-        render_pass_info.pDependencies          = subpassDependencies.data();
-
-        VK_EXCEPT(vkCreateRenderPass(m_device, &render_pass_info, nullptr, &render_pass));
-    }
-
     VkFramebuffer framebuffer = VK_NULL_HANDLE;
     {
         std::array<VkImageView, 1> attachments = { m_swapchain_image_views[m_curr_sc_img_index] };
@@ -691,7 +930,7 @@ void Graphics::drawTestData()
         VkFramebufferCreateInfo framebuffer_info = { VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
         framebuffer_info.pNext                   = nullptr;
         framebuffer_info.flags                   = 0;
-        framebuffer_info.renderPass              = render_pass;
+        framebuffer_info.renderPass              = m_render_pass;
         framebuffer_info.attachmentCount         = static_cast<uint32_t>(attachments.size());
         framebuffer_info.pAttachments            = attachments.data();
         framebuffer_info.width                   = m_swapchain_image_extent.width;
@@ -701,10 +940,7 @@ void Graphics::drawTestData()
         VK_EXCEPT(vkCreateFramebuffer(m_device, &framebuffer_info, nullptr, &framebuffer));
     }
 
-    vertex::Layout layout;
-    layout.append(vertex::AttributeType::Pos3d);
-    layout.append(vertex::AttributeType::TexCoords);
-    Box box(*this, layout);
+    Box box(*this, *m_test_layout);
     box.update(0.0f, (float)glfwGetTime());
 
     UniformBuffer<UniformBufferObject> uniform_buffer(*this);
@@ -716,14 +952,10 @@ void Graphics::drawTestData()
         ubo->proj[1][1] *= -1;
     }
 
-    vulkan::DescriptorSetContainer dset(m_device);
-    VkPipeline                     graphics_pipeline = VK_NULL_HANDLE;
+    vulkan::DescriptorSetContainer& dset              = *m_test_dset;
+    vulkan::GraphicsPipelineState&  pstate            = *m_test_pipeline_state;
+    VkPipeline                      graphics_pipeline = VK_NULL_HANDLE;
     {
-        dset.addBinding(BINDING_UBO, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_ALL);
-        dset.initLayout();
-        dset.initPool(k_max_in_flight_count);
-        dset.initPipeLayout();
-
         {
             VkDescriptorBufferInfo buffer_info = uniform_buffer.makeInfo(0);
 
@@ -732,25 +964,23 @@ void Graphics::drawTestData()
             vkUpdateDescriptorSets(m_device, (uint32_t)writes.size(), writes.data(), 0, nullptr);
         }
 
-        const uint32_t binding = 0;
+        const VkFormat color_format = m_swapchain_surface_format.format;
 
-        VkVertexInputBindingDescription binding_desc = layout.getBindingDesc(binding);
+        vulkan::GraphicsPipelineGenerator pgen(m_device, dset.getPipeLayout(), m_render_pass, pstate);
+        pgen.setPipelineCache(m_pipeline_cache);
+        pgen.setRenderTargetFormats({ &color_format, 1 });
 
-        std::vector<VkVertexInputAttributeDescription> attribute_descs;
-        layout.getAttributeDescs(binding, attribute_descs);
-
-        vulkan::GraphicsPipelineState pstate{};
-        pstate.rasterizationState.cullMode = VK_CULL_MODE_BACK_BIT;
-        pstate.addBindingDescription(binding_desc);
-        pstate.addAttributeDescriptions(attribute_descs);
+        const vulkan::ShaderLibrary::Shader& vert = m_shader_library->get("test.vert.spv");
+        const vulkan::ShaderLibrary::Shader& frag = m_shader_library->get("test.frag.spv");
+        pgen.addShader(vert.module, vert.hash, VK_SHADER_STAGE_VERTEX_BIT, "main");
+        pgen.addShader(frag.module, frag.hash, VK_SHADER_STAGE_FRAGMENT_BIT, "main");
 
-        vulkan::GraphicsPipelineGenerator pgen(m_device, dset.getPipeLayout(), render_pass, pstate);
-        pgen.addShader(loadShaderCode("test.vert.spv"), VK_SHADER_STAGE_VERTEX_BIT, "main");
-        pgen.addShader(loadShaderCode("test.frag.spv"), VK_SHADER_STAGE_FRAGMENT_BIT, "main");
+        vulkan::SpecializationConstants frag_constants;
+        frag_constants.set(k_spec_uv_color, true);
+        pgen.setSpecialization(VK_SHADER_STAGE_FRAGMENT_BIT, frag_constants);
 
-        graphics_pipeline = pgen.createPipeline();
-
-        pgen.clearShaders();
+        // Not ready on the first frames: the draw is skipped until the worker threads are done.
+        graphics_pipeline = m_pipeline_compiler->request(pgen);
     }
 
 
@@ -761,6 +991,7 @@ void Graphics::drawTestData()
     begin_info.flags                    = 0;
     begin_info.pInheritanceInfo         = nullptr;
     VK_EXCEPT(vkBeginCommandBuffer(cmd, &begin_info));
+    m_dynamic_state->begin(cmd);
     {
         VkClearValue clear_color = { .color{ .float32{ 0.1f, 0.1f, 0.1f, 1.0f } } };
 
@@ -774,7 +1005,7 @@ void Graphics::drawTestData()
         VkRenderPassBeginInfo render_pass_begin{};
         render_pass_begin.sType           = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
         render_pass_begin.pNext           = nullptr;
-        render_pass_begin.renderPass      = render_pass;
+        render_pass_begin.renderPass      = m_render_pass;
         render_pass_begin.framebuffer     = framebuffer;
         render_pass_begin.renderArea      = area;
         render_pass_begin.clearValueCount = 1;
@@ -790,12 +1021,16 @@ void Graphics::drawTestData()
                                     0,
                                     nullptr);
 
-            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline);
+            if (graphics_pipeline != VK_NULL_HANDLE)
+            {
+                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline);
 
-            vkCmdSetViewport(cmd, 0, 1, &viewport);
-            vkCmdSetScissor(cmd, 0, 1, &area);
+                m_dynamic_state->apply(pstate);
+                m_dynamic_state->setViewport(viewport);
+                m_dynamic_state->setScissor(area);
 
-            box.draw(*this);
+                box.draw(*this);
+            }
         }
         vkCmdEndRenderPass(cmd);
     }
@@ -837,24 +1072,66 @@ void Graphics::drawTestData()
 
     // Destroy resources.
     {
-        vkDestroyPipeline(m_device, graphics_pipeline, nullptr);
-
         box.destroy(*this);
 
         uniform_buffer.reset(*this);
 
         vkDestroyFramebuffer(m_device, framebuffer, nullptr);
-
-        vkDestroyRenderPass(m_device, render_pass, nullptr);
     }
 
 
     m_curr_frame_index = (m_curr_frame_index + 1) % k_max_in_flight_count;
 }
 
-void Graphics::drawIndexed(uint32_t count)
+void Graphics::drawIndexed(uint32_t count, uint32_t first_index, int32_t vertex_offset)
+{
+    drawIndexedInstanced(count, 1, first_index, vertex_offset);
+}
+
+void Graphics::drawIndexedInstanced(uint32_t count,
+                                    uint32_t instance_count,
+                                    uint32_t first_index,
+                                    int32_t  vertex_offset,
+                                    uint32_t first_instance)
+{
+    vkCmdDrawIndexed(getCurrSwapchainCmd(), count, instance_count, first_index, vertex_offset, first_instance);
+}
+
+bool Graphics::bindComputePipeline(vulkan::ComputePipelineGenerator& generator)
+{
+    generator.setPipelineCache(m_pipeline_cache);
+    VkPipeline pipeline = m_pso_cache->getOrCreate(generator);
+    if (pipeline == VK_NULL_HANDLE)
+    {
+        return false;
+    }
+    vkCmdBindPipeline(getCurrSwapchainCmd(), VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    return true;
+}
+
+void Graphics::dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z)
+{
+    vkCmdDispatch(getCurrSwapchainCmd(), group_count_x, group_count_y, group_count_z);
+}
+
+void Graphics::dispatchIndirect(VkBuffer buffer, VkDeviceSize offset)
+{
+    vkCmdDispatchIndirect(getCurrSwapchainCmd(), buffer, offset);
+}
+
+void Graphics::barrierComputeToCompute()
+{
+    vulkan::cmdComputeToComputeBarrier(getCurrSwapchainCmd());
+}
+
+void Graphics::barrierComputeToIndirect()
+{
+    vulkan::cmdComputeToIndirectBarrier(getCurrSwapchainCmd());
+}
+
+void Graphics::barrierComputeToGraphics()
 {
-    vkCmdDrawIndexed(getCurrSwapchainCmd(), count, 1, 0, 0, 0);
+    vulkan::cmdComputeToGraphicsBarrier(getCurrSwapchainCmd());
 }
 
 void Graphics::updateDescriptorSets(std::span<const VkWriteDescriptorSet> writes, std::span<const VkCopyDescriptorSet> copies)
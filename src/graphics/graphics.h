@@ -1,4 +1,5 @@
 #pragma once
+#include <memory>
 #include <numeric>
 #include <vector>
 #include <span>
@@ -7,8 +8,26 @@
 
 #include "utils/exception.h"
 
+class ShaderHotReload;
 class Window;
 
+namespace vulkan
+{
+class DescriptorSetContainer;
+class DynamicStateRecorder;
+class PipelineCompiler;
+class PipelineLibraryCache;
+class PipelineStateCache;
+class ShaderLibrary;
+struct ComputePipelineGenerator;
+struct GraphicsPipelineState;
+}  // namespace vulkan
+
+namespace vertex
+{
+class Layout;
+}  // namespace vertex
+
 class Graphics
 {
     friend class GraphicsAvailable;
@@ -43,7 +62,24 @@ public:
 
     void drawTestData();
 
-    void drawIndexed(uint32_t count);
+    void drawIndexed(uint32_t count, uint32_t first_index = 0, int32_t vertex_offset = 0);
+    // Draws `instance_count` copies in one call, the per-instance streams starting at `first_instance`.
+    void drawIndexedInstanced(uint32_t count,
+                              uint32_t instance_count,
+                              uint32_t first_index    = 0,
+                              int32_t  vertex_offset  = 0,
+                              uint32_t first_instance = 0);
+
+    // Compute passes, recorded outside of render passes. The pipeline comes from the PSO cache and is built on first use;
+    // returns false, without binding anything, if it cannot be created.
+    bool bindComputePipeline(vulkan::ComputePipelineGenerator& generator);
+    void dispatch(uint32_t group_count_x, uint32_t group_count_y = 1, uint32_t group_count_z = 1);
+    void dispatchIndirect(VkBuffer buffer, VkDeviceSize offset = 0);
+
+    // Make what the previous dispatches wrote visible to the next pass.
+    void barrierComputeToCompute();
+    void barrierComputeToIndirect();
+    void barrierComputeToGraphics();
 
     void updateDescriptorSets(std::span<const VkWriteDescriptorSet> writes, std::span<const VkCopyDescriptorSet> copies);
 
@@ -71,9 +107,21 @@ private:
     uint32_t         m_queue_family_index_present  = k_invalid_queue_index;
     VkDevice         m_device                      = VK_NULL_HANDLE;
 
+    bool m_graphics_pipeline_library_enabled = false;  // VK_EXT_graphics_pipeline_library with fast linking.
+    bool m_extended_dynamic_state3_enabled   = false;  // VK_EXT_extended_dynamic_state3 with the states of GraphicsPipelineState.
+    bool m_index_type_uint8_enabled          = false;  // VK_EXT_index_type_uint8, for the index buffers of tiny meshes.
+
     VkQueue m_queue_graphics = VK_NULL_HANDLE;
     VkQueue m_queue_present  = VK_NULL_HANDLE;
 
+    VkPipelineCache                               m_pipeline_cache = VK_NULL_HANDLE;  // Persisted next to the shader binaries between runs.
+    std::unique_ptr<vulkan::PipelineStateCache>   m_pso_cache;                        // Owns every pipeline, deduplicated by state hash.
+    std::unique_ptr<vulkan::PipelineCompiler>     m_pipeline_compiler;                // Builds missing pipelines on worker threads.
+    std::unique_ptr<vulkan::PipelineLibraryCache> m_pipeline_libraries;               // Only with m_graphics_pipeline_library_enabled.
+    std::unique_ptr<vulkan::DynamicStateRecorder> m_dynamic_state;                    // Skips redundant vkCmdSet* calls.
+    std::unique_ptr<vulkan::ShaderLibrary>        m_shader_library;                   // Shader modules, loaded once.
+    std::unique_ptr<ShaderHotReload>              m_shader_hot_reload;                // Only when the shader sources are present.
+
     VkSurfaceFormatKHR         m_swapchain_surface_format;
     uint32_t                   m_swapchain_image_count = 0;
     VkExtent2D                 m_swapchain_image_extent;
@@ -84,6 +132,11 @@ private:
     std::vector<VkImage>     m_swapchain_images;       // Swapchain image is created by swapchain.
     std::vector<VkImageView> m_swapchain_image_views;  // Swapchain image view is created by Graphics.
 
+    VkRenderPass                                    m_render_pass = VK_NULL_HANDLE;
+    std::unique_ptr<vulkan::DescriptorSetContainer> m_test_dset;            // Bindings reflected from the test shaders.
+    std::unique_ptr<vertex::Layout>                 m_test_layout;
+    std::unique_ptr<vulkan::GraphicsPipelineState>  m_test_pipeline_state;  // Checked against the vertex shader inputs.
+
     VkCommandPool                m_swapchain_image_present_cmd_pool = VK_NULL_HANDLE;
     std::vector<VkCommandBuffer> m_swapchain_image_present_cmds;
     std::vector<VkSemaphore>     m_swapchain_render_finished_semaphores;
@@ -13,11 +13,15 @@ protected:
     static VkPhysicalDevice getActiveGpu(Graphics& gfx) noexcept { return gfx.m_active_gpu; }
     static VkDevice         getDevice(Graphics& gfx) noexcept { return gfx.m_device; }
 
+    static bool isIndexTypeUint8Enabled(Graphics& gfx) noexcept { return gfx.m_index_type_uint8_enabled; }
+
     static uint32_t getQueueFamilyIndexGraphics(Graphics& gfx) noexcept { return gfx.m_queue_family_index_graphics; }
     static uint32_t getQueueFamilyIndexPresent(Graphics& gfx) noexcept { return gfx.m_queue_family_index_present; }
     static VkQueue  getQueueGraphics(Graphics& gfx) noexcept { return gfx.m_queue_graphics; }
     static VkQueue  getQueuePresent(Graphics& gfx) noexcept { return gfx.m_queue_present; }
 
+    static VkPipelineCache getPipelineCache(Graphics& gfx) noexcept { return gfx.m_pipeline_cache; }
+
     static VkSwapchainKHR getSwapchain(Graphics& gfx) noexcept { return gfx.m_swapchain; }
     static VkImage        getCurrSwapchainImage(Graphics& gfx) noexcept { return gfx.m_swapchain_images[gfx.m_curr_sc_img_index]; }
     static VkImageView    getCurrSwapchainImageView(Graphics& gfx) noexcept { return gfx.m_swapchain_image_views[gfx.m_curr_sc_img_index]; }
@@ -0,0 +1,40 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <vector>
+
+// Internal to graphics/mesh: shared by the index optimizer and the meshlet builder.
+namespace mesh
+{
+
+// Triangles using each vertex: those of vertex v are triangles[offsets[v]] to triangles[offsets[v + 1]].
+struct Adjacency
+{
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> triangles;
+};
+
+template <typename T>
+Adjacency buildAdjacency(std::span<const T> indices, size_t vertexCount)
+{
+    Adjacency adjacency;
+    adjacency.offsets.assign(vertexCount + 1, 0);
+    for (T index : indices)
+    {
+        assert(index < vertexCount);
+        ++adjacency.offsets[index + 1];
+    }
+    std::partial_sum(adjacency.offsets.begin(), adjacency.offsets.end(), adjacency.offsets.begin());
+
+    std::vector<uint32_t> fill(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+    adjacency.triangles.resize(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        adjacency.triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+    return adjacency;
+}
+
+}  // namespace mesh
@@ -0,0 +1,337 @@
+#include "graphics/mesh/index_optimizer.h"
+#include "graphics/mesh/adjacency.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+namespace mesh
+{
+
+namespace
+{
+
+constexpr uint32_t k_no_vertex = ~0u;
+
+// FIFO post-transform cache: a vertex is cached while fewer than `size` misses happened since its own. A new cache
+// is a time jump past every timestamp.
+class VertexCache
+{
+public:
+    VertexCache(size_t vertexCount, uint32_t size)
+        : m_timestamps(vertexCount, 0)
+        , m_time(size + 1)
+        , m_size(size)
+    {}
+
+    uint32_t age(uint32_t vertex) const noexcept { return m_time - m_timestamps[vertex]; }
+    bool     contains(uint32_t vertex) const noexcept { return age(vertex) <= m_size; }
+    uint32_t size() const noexcept { return m_size; }
+
+    // Returns true on a miss.
+    bool access(uint32_t vertex) noexcept
+    {
+        if (contains(vertex))
+        {
+            return false;
+        }
+        m_timestamps[vertex] = m_time++;
+        return true;
+    }
+
+    void clear() noexcept { m_time += m_size + 1; }
+
+private:
+    std::vector<uint32_t> m_timestamps;
+    uint32_t              m_time;
+    uint32_t              m_size;
+};
+
+template <typename T>
+VertexCacheStats analyze(std::span<const T> indices, size_t vertexCount, uint32_t cacheSize)
+{
+    VertexCache       cache(vertexCount, cacheSize);
+    std::vector<bool> referenced(vertexCount, false);
+    size_t            uniqueCount = 0;
+
+    VertexCacheStats stats;
+    for (T index : indices)
+    {
+        assert(index < vertexCount);
+        stats.transformed += cache.access(index) ? 1 : 0;
+        if (!referenced[index])
+        {
+            referenced[index] = true;
+            ++uniqueCount;
+        }
+    }
+
+    const size_t triangleCount = indices.size() / 3;
+    stats.acmr                 = triangleCount != 0 ? static_cast<float>(stats.transformed) / triangleCount : 0.0f;
+    stats.atvr                 = uniqueCount != 0 ? static_cast<float>(stats.transformed) / uniqueCount : 0.0f;
+    return stats;
+}
+
+template <typename T>
+void tipsify(std::span<T> dst, std::span<const T> indices, size_t vertexCount, uint32_t cacheSize)
+{
+    assert(dst.size() == indices.size() && indices.size() % 3 == 0);
+
+    const size_t    triangleCount = indices.size() / 3;
+    const Adjacency adjacency     = buildAdjacency(indices, vertexCount);
+
+    // Triangles left to emit around each vertex.
+    std::vector<uint32_t> live(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        live[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+    }
+
+    VertexCache           cache(vertexCount, cacheSize);
+    std::vector<bool>     emitted(triangleCount, false);
+    std::vector<uint32_t> deadEnd;  // Recently used vertices, to restart from when a fan has no good successor.
+    std::vector<uint32_t> candidates;
+    std::vector<T>        result;
+    result.reserve(indices.size());
+
+    auto nextVertex = [&](size_t& cursor) {
+        // The oldest candidate that is still cached once its remaining triangles are emitted, else any candidate.
+        uint32_t best         = k_no_vertex;
+        int64_t  bestPriority = -1;
+        for (uint32_t v : candidates)
+        {
+            if (live[v] == 0)
+            {
+                continue;
+            }
+            const int64_t priority = cache.age(v) + 2 * live[v] <= cache.size() ? cache.age(v) : 0;
+            if (priority > bestPriority)
+            {
+                best         = v;
+                bestPriority = priority;
+            }
+        }
+        if (best != k_no_vertex)
+        {
+            return best;
+        }
+
+        while (!deadEnd.empty())
+        {
+            const uint32_t v = deadEnd.back();
+            deadEnd.pop_back();
+            if (live[v] != 0)
+            {
+                return v;
+            }
+        }
+        for (; cursor < vertexCount; ++cursor)
+        {
+            if (live[cursor] != 0)
+            {
+                return static_cast<uint32_t>(cursor);
+            }
+        }
+        return k_no_vertex;
+    };
+
+    size_t   cursor  = 0;
+    uint32_t fanning = nextVertex(cursor);
+    while (fanning != k_no_vertex)
+    {
+        candidates.clear();
+        for (uint32_t i = adjacency.offsets[fanning]; i < adjacency.offsets[fanning + 1]; ++i)
+        {
+            const uint32_t triangle = adjacency.triangles[i];
+            if (emitted[triangle])
+            {
+                continue;
+            }
+            emitted[triangle] = true;
+
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                const T v = indices[triangle * 3 + corner];
+                result.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                --live[v];
+                cache.access(v);
+            }
+        }
+        fanning = nextVertex(cursor);
+    }
+
+    std::copy(result.begin(), result.end(), dst.begin());
+}
+
+template <typename T>
+glm::vec3 loadPosition(vertex::ConstStridedBytes positions, T index) noexcept
+{
+    float xyz[3];
+    std::memcpy(xyz, positions.data + index * positions.stride, sizeof(xyz));
+    return glm::vec3(xyz[0], xyz[1], xyz[2]);
+}
+
+template <typename T>
+void sortClusters(std::span<T>              dst,
+                  std::span<const T>        indices,
+                  vertex::ConstStridedBytes positions,
+                  size_t                    vertexCount,
+                  float                     threshold)
+{
+    assert(dst.size() == indices.size() && indices.size() % 3 == 0);
+
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+    {
+        return;
+    }
+    VertexCache cache(vertexCount, k_vertex_cache_size);
+
+    auto triangleMisses = [&](size_t triangle) {
+        uint32_t misses = 0;
+        for (size_t corner = 0; corner < 3; ++corner)
+        {
+            misses += cache.access(indices[triangle * 3 + corner]) ? 1 : 0;
+        }
+        return misses;
+    };
+
+    // Hard boundaries: a triangle missing all its vertices shares nothing with the ones before, so cutting there costs
+    // no extra vertex shader invocation. The first triangle always starts one, even when it is degenerate and misses
+    // fewer than 3.
+    std::vector<uint32_t> hard = { 0 };
+    for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+    {
+        if (triangleMisses(triangle) == 3 && triangle != 0)
+        {
+            hard.push_back(static_cast<uint32_t>(triangle));
+        }
+    }
+    hard.push_back(static_cast<uint32_t>(triangleCount));
+
+    // Soft boundaries: inside a hard cluster, cut as soon as the part since the last cut, drawn with a cold cache, is
+    // within `threshold` of the ACMR of the whole cluster.
+    std::vector<uint32_t> clusters;  // First triangle of each cluster, then the triangle count.
+    for (size_t h = 0; h + 1 < hard.size(); ++h)
+    {
+        cache.clear();
+        uint32_t clusterMisses = 0;
+        for (uint32_t triangle = hard[h]; triangle < hard[h + 1]; ++triangle)
+        {
+            clusterMisses += triangleMisses(triangle);
+        }
+        const float limit = threshold * clusterMisses / (hard[h + 1] - hard[h]);
+
+        cache.clear();
+        uint32_t start  = hard[h];
+        uint32_t misses = 0;
+        clusters.push_back(start);
+        for (uint32_t triangle = hard[h]; triangle + 1 < hard[h + 1]; ++triangle)
+        {
+            misses += triangleMisses(triangle);
+            if (misses <= limit * (triangle + 1 - start))
+            {
+                start  = triangle + 1;
+                misses = 0;
+                clusters.push_back(start);
+                cache.clear();
+            }
+        }
+    }
+    clusters.push_back(static_cast<uint32_t>(triangleCount));
+
+    glm::vec3 meshCenter(0.0f);
+    for (T index : indices)
+    {
+        meshCenter += loadPosition(positions, index);
+    }
+    meshCenter /= static_cast<float>(std::max<size_t>(indices.size(), 1));
+
+    // Clusters whose area-weighted normal points away from the mesh center are outside surfaces: drawn first, they
+    // hide what is behind them.
+    const size_t       clusterCount = clusters.size() - 1;
+    std::vector<float> sortKeys(clusterCount, 0.0f);
+    for (size_t c = 0; c < clusterCount; ++c)
+    {
+        glm::vec3 normal(0.0f);
+        glm::vec3 center(0.0f);
+        float     area = 0.0f;
+        for (uint32_t triangle = clusters[c]; triangle < clusters[c + 1]; ++triangle)
+        {
+            const glm::vec3 p0 = loadPosition(positions, indices[triangle * 3 + 0]);
+            const glm::vec3 p1 = loadPosition(positions, indices[triangle * 3 + 1]);
+            const glm::vec3 p2 = loadPosition(positions, indices[triangle * 3 + 2]);
+
+            const glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+            const float     a = glm::length(n);
+
+            normal += n;
+            center += (p0 + p1 + p2) * (a / 3.0f);
+            area   += a;
+        }
+
+        const float normalLength = glm::length(normal);
+        if (area > 0.0f && normalLength > 0.0f)
+        {
+            sortKeys[c] = glm::dot(center / area - meshCenter, normal / normalLength);
+        }
+    }
+
+    std::vector<uint32_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+    std::vector<T> result;
+    result.reserve(indices.size());
+    for (uint32_t c : order)
+    {
+        result.insert(result.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+    }
+    assert(result.size() == indices.size());
+    std::copy(result.begin(), result.end(), dst.begin());
+}
+
+}  // namespace
+
+VertexCacheStats analyzeVertexCache(std::span<const uint16_t> indices, size_t vertexCount, uint32_t cacheSize)
+{
+    return analyze(indices, vertexCount, cacheSize);
+}
+
+VertexCacheStats analyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize)
+{
+    return analyze(indices, vertexCount, cacheSize);
+}
+
+void optimizeVertexCache(std::span<uint16_t> dst, std::span<const uint16_t> indices, size_t vertexCount)
+{
+    tipsify(dst, indices, vertexCount, k_vertex_cache_size);
+}
+
+void optimizeVertexCache(std::span<uint32_t> dst, std::span<const uint32_t> indices, size_t vertexCount)
+{
+    tipsify(dst, indices, vertexCount, k_vertex_cache_size);
+}
+
+void optimizeOverdraw(std::span<uint16_t>       dst,
+                      std::span<const uint16_t> indices,
+                      vertex::ConstStridedBytes positions,
+                      size_t                    vertexCount,
+                      float                     threshold)
+{
+    sortClusters(dst, indices, positions, vertexCount, threshold);
+}
+
+void optimizeOverdraw(std::span<uint32_t>       dst,
+                      std::span<const uint32_t> indices,
+                      vertex::ConstStridedBytes positions,
+                      size_t                    vertexCount,
+                      float                     threshold)
+{
+    sortClusters(dst, indices, positions, vertexCount, threshold);
+}
+
+}  // namespace mesh
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <span>
+
+#include "graphics/vertex_convert.h"
+
+namespace mesh
+{
+
+// Triangle list passes run before the indices are uploaded: first optimizeVertexCache(), so the GPU reuses the vertex
+// shader results of recent vertices, then optionally optimizeOverdraw(), which moves whole clusters of triangles so the
+// outer surfaces are drawn first while keeping most of the cache locality. Every function has a 16 and a 32-bit
+// overload, and `dst` may alias `indices`.
+//
+//     mesh::optimizeVertexCache(indices, indices, vertexCount);
+//     mesh::optimizeOverdraw(indices, indices, { positions, sizeof(glm::vec3) }, vertexCount);
+//     LogInfo("ACMR {}", mesh::analyzeVertexCache(indices, vertexCount).acmr);
+
+struct VertexCacheStats
+{
+    uint32_t transformed = 0;     // Vertex shader invocations.
+    float    acmr        = 0.0f;  // Average cache miss ratio: invocations per triangle, from 0.5 at best to 3.
+    float    atvr        = 0.0f;  // Average transformed vertex ratio: invocations per referenced vertex, 1 at best.
+};
+
+// Post-transform cache size the passes and the statistics assume: a FIFO of this many vertices.
+constexpr uint32_t k_vertex_cache_size = 16;
+
+// Simulates a FIFO post-transform cache of `cacheSize` vertices.
+VertexCacheStats analyzeVertexCache(std::span<const uint16_t> indices, size_t vertexCount, uint32_t cacheSize = k_vertex_cache_size);
+VertexCacheStats analyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize = k_vertex_cache_size);
+
+// Reorders the triangles with Tipsify (Sander, Nehab and Barczak 2007): fans around the most recently cached vertex,
+// in linear time.
+void optimizeVertexCache(std::span<uint16_t> dst, std::span<const uint16_t> indices, size_t vertexCount);
+void optimizeVertexCache(std::span<uint32_t> dst, std::span<const uint32_t> indices, size_t vertexCount);
+
+// Splits the vertex cache optimized list into clusters, only where the cache misses allow it (`threshold` is the
+// worst ACMR ratio accepted, 1.05 for 5%), and draws the clusters facing away from the mesh center first.
+// `positions` holds 3 floats per vertex.
+void optimizeOverdraw(std::span<uint16_t>       dst,
+                      std::span<const uint16_t> indices,
+                      vertex::ConstStridedBytes positions,
+                      size_t                    vertexCount,
+                      float                     threshold = 1.05f);
+void optimizeOverdraw(std::span<uint32_t>       dst,
+                      std::span<const uint32_t> indices,
+                      vertex::ConstStridedBytes positions,
+                      size_t                    vertexCount,
+                      float                     threshold = 1.05f);
+
+}  // namespace mesh
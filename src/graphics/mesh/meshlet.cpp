@@ -0,0 +1,345 @@
+#include "graphics/mesh/meshlet.h"
+#include "graphics/mesh/adjacency.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace mesh
+{
+
+namespace
+{
+
+constexpr uint8_t  k_not_in_meshlet = 0xff;
+constexpr uint32_t k_no_triangle    = ~0u;
+
+// Below this, the normals spread over more than a hemisphere minus a few degrees and the cone would never cull.
+constexpr float k_min_cone_dot = 0.1f;
+
+template <typename T>
+Meshlets build(std::span<const T> indices, size_t vertexCount, size_t maxVertices, size_t maxTriangles)
+{
+    // Micro-indices are 8-bit, and k_not_in_meshlet is one of their values.
+    assert(indices.size() % 3 == 0);
+    assert(maxVertices >= 3 && maxVertices < k_not_in_meshlet && maxTriangles >= 1);
+
+    const size_t    triangleCount = indices.size() / 3;
+    const Adjacency adjacency     = buildAdjacency(indices, vertexCount);
+
+    // Triangles left around each vertex: exhausted vertices are skipped when looking for neighbours.
+    std::vector<uint32_t> live(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        live[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+    }
+
+    Meshlets result;
+    result.meshlets.reserve(triangleCount / maxTriangles + 1);
+    result.vertices.reserve(triangleCount);
+    result.triangles.reserve(indices.size() + 3 * (triangleCount / maxTriangles + 1));
+
+    std::vector<uint8_t> local(vertexCount, k_not_in_meshlet);  // Micro-index of each vertex in the current meshlet.
+    std::vector<bool>    emitted(triangleCount, false);
+    Meshlet              current;
+
+    auto newVertexCount = [&](uint32_t triangle) {
+        uint32_t count = 0;
+        for (size_t corner = 0; corner < 3; ++corner)
+        {
+            count += local[indices[triangle * 3 + corner]] == k_not_in_meshlet ? 1 : 0;
+        }
+        return count;
+    };
+
+    // The triangle sharing a vertex with the current meshlet that adds the fewest vertices and still fits. Vertices are
+    // visited in the order they joined, so ties go to the oldest ones: the meshlet grows in rings around its seed
+    // instead of in a strip along its boundary. Exhausted vertices at the front are never visited again.
+    size_t firstLive    = 0;
+    auto   bestAdjacent = [&]() {
+        while (firstLive < result.vertices.size() && live[result.vertices[firstLive]] == 0)
+        {
+            ++firstLive;
+        }
+
+        uint32_t best      = k_no_triangle;
+        uint32_t bestCount = 4;
+        for (size_t i = firstLive; i < result.vertices.size(); ++i)
+        {
+            const uint32_t v = result.vertices[i];
+            if (live[v] == 0)
+            {
+                continue;
+            }
+            for (uint32_t a = adjacency.offsets[v]; a < adjacency.offsets[v + 1]; ++a)
+            {
+                const uint32_t triangle = adjacency.triangles[a];
+                if (emitted[triangle])
+                {
+                    continue;
+                }
+                const uint32_t count = newVertexCount(triangle);
+                if (count < bestCount && current.vertex_count + count <= maxVertices)
+                {
+                    if (count == 0)
+                    {
+                        return triangle;
+                    }
+                    best      = triangle;
+                    bestCount = count;
+                }
+            }
+        }
+        return best;
+    };
+
+    auto flush = [&]() {
+        for (size_t i = current.vertex_offset; i < result.vertices.size(); ++i)
+        {
+            local[result.vertices[i]] = k_not_in_meshlet;
+        }
+        result.triangles.resize((result.triangles.size() + 3) & ~size_t(3), 0);
+        result.meshlets.push_back(current);
+
+        current                 = {};
+        current.vertex_offset   = static_cast<uint32_t>(result.vertices.size());
+        current.triangle_offset = static_cast<uint32_t>(result.triangles.size());
+        firstLive               = current.vertex_offset;
+    };
+
+    size_t cursor = 0;
+    for (size_t i = 0; i < triangleCount; ++i)
+    {
+        uint32_t triangle = current.triangle_count < maxTriangles ? bestAdjacent() : k_no_triangle;
+        if (triangle == k_no_triangle)
+        {
+            // Nothing connected fits: the next triangle in index order joins if it can, else seeds the next meshlet.
+            while (emitted[cursor])
+            {
+                ++cursor;
+            }
+            triangle = static_cast<uint32_t>(cursor);
+        }
+        if (current.triangle_count == maxTriangles || current.vertex_count + newVertexCount(triangle) > maxVertices)
+        {
+            flush();
+        }
+
+        emitted[triangle] = true;
+        for (size_t corner = 0; corner < 3; ++corner)
+        {
+            const T v = indices[triangle * 3 + corner];
+            if (local[v] == k_not_in_meshlet)
+            {
+                local[v] = static_cast<uint8_t>(current.vertex_count++);
+                result.vertices.push_back(v);
+            }
+            result.triangles.push_back(local[v]);
+            --live[v];
+        }
+        ++current.triangle_count;
+    }
+    if (current.triangle_count != 0)
+    {
+        flush();
+    }
+    return result;
+}
+
+// Vertex positions, from Pos3d or decoded from Pos3dHalf.
+class Positions
+{
+public:
+    explicit Positions(const vertex::Buffer& vertices)
+    {
+        using T = vertex::AttributeType;
+
+        const vertex::Layout& layout = vertices.layout();
+        if (!layout.hasElement(T::Pos3d) && !layout.hasElement(T::Pos3dHalf))
+        {
+            throw std::runtime_error("mesh::computeMeshletBounds: the vertices have no Pos3d or Pos3dHalf attribute");
+        }
+
+        m_half                              = !layout.hasElement(T::Pos3d);
+        const vertex::Layout::Attribute& at = layout.resolve(m_half ? T::Pos3dHalf : T::Pos3d);
+        m_data                              = vertices.dataPtr(at.stream()) + at.offset();
+        m_stride                            = layout.getStride(at.stream());
+    }
+
+    glm::vec3 operator[](uint32_t vertex) const noexcept
+    {
+        const std::byte* data = m_data + vertex * m_stride;
+        if (m_half)
+        {
+            vertex::Half3 half;
+            std::memcpy(&half.bits, data, sizeof(half.bits));
+            return half.decode();
+        }
+        float xyz[3];
+        std::memcpy(xyz, data, sizeof(xyz));
+        return glm::vec3(xyz[0], xyz[1], xyz[2]);
+    }
+
+private:
+    const std::byte* m_data   = nullptr;
+    size_t           m_stride = 0;
+    bool             m_half   = false;
+};
+
+// Ritter: a sphere through the farthest pair among the extreme points on each axis, grown to every point outside it.
+// Within a few percent of the minimal sphere on meshlet sized point sets.
+void boundingSphere(std::span<const glm::vec3> points, glm::vec3& center, float& radius) noexcept
+{
+    size_t lo[3] = { 0, 0, 0 };
+    size_t hi[3] = { 0, 0, 0 };
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            lo[axis] = points[i][axis] < points[lo[axis]][axis] ? i : lo[axis];
+            hi[axis] = points[i][axis] > points[hi[axis]][axis] ? i : hi[axis];
+        }
+    }
+
+    int widest = 0;
+    for (int axis = 1; axis < 3; ++axis)
+    {
+        if (glm::distance(points[lo[axis]], points[hi[axis]]) > glm::distance(points[lo[widest]], points[hi[widest]]))
+        {
+            widest = axis;
+        }
+    }
+
+    center = (points[lo[widest]] + points[hi[widest]]) * 0.5f;
+    radius = glm::distance(points[lo[widest]], points[hi[widest]]) * 0.5f;
+    for (const glm::vec3& point : points)
+    {
+        const float distance = glm::distance(point, center);
+        if (distance > radius)
+        {
+            const float grown = (radius + distance) * 0.5f;
+            center           += (point - center) * ((grown - radius) / distance);
+            radius            = grown;
+        }
+    }
+}
+
+void store(float (&dst)[3], const glm::vec3& v) noexcept
+{
+    dst[0] = v.x;
+    dst[1] = v.y;
+    dst[2] = v.z;
+}
+
+MeshletBounds computeBounds(const Meshlets& meshlets, const Meshlet& meshlet, const Positions& positions)
+{
+    std::vector<glm::vec3> points(meshlet.vertex_count);
+    for (uint32_t i = 0; i < meshlet.vertex_count; ++i)
+    {
+        points[i] = positions[meshlets.vertices[meshlet.vertex_offset + i]];
+    }
+
+    MeshletBounds bounds;
+    glm::vec3     center(0.0f);
+    boundingSphere(points, center, bounds.radius);
+    store(bounds.center, center);
+
+    // Unit face normals, and their average as cone axis; degenerate triangles face nowhere and are left out.
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec3> corners;  // One corner of each triangle in `normals`.
+    glm::vec3              axis(0.0f);
+    for (uint32_t t = 0; t < meshlet.triangle_count; ++t)
+    {
+        const uint8_t*  local = &meshlets.triangles[meshlet.triangle_offset + t * 3];
+        const glm::vec3 p0    = points[local[0]];
+        const glm::vec3 n     = glm::cross(points[local[1]] - p0, points[local[2]] - p0);
+        const float     area  = glm::length(n);
+        if (area > 0.0f)
+        {
+            normals.push_back(n / area);
+            corners.push_back(p0);
+            axis += n / area;
+        }
+    }
+
+    const float axisLength = glm::length(axis);
+    if (normals.empty() || axisLength == 0.0f)
+    {
+        return bounds;
+    }
+    axis /= axisLength;
+
+    float minDot = 1.0f;
+    for (const glm::vec3& normal : normals)
+    {
+        minDot = std::min(minDot, glm::dot(normal, axis));
+    }
+    if (minDot <= k_min_cone_dot)
+    {
+        return bounds;
+    }
+
+    // The apex is moved back along the axis until it is behind every triangle plane: from any point of the cone it
+    // spans, each triangle is seen from behind.
+    float apexDistance = 0.0f;
+    for (size_t i = 0; i < normals.size(); ++i)
+    {
+        apexDistance = std::max(apexDistance, glm::dot(center - corners[i], normals[i]) / glm::dot(axis, normals[i]));
+    }
+
+    store(bounds.cone_apex, center - axis * apexDistance);
+    store(bounds.cone_axis, axis);
+    bounds.cone_cutoff = std::sqrt(1.0f - minDot * minDot);
+    return bounds;
+}
+
+glm::vec3 load(const float (&src)[3]) noexcept
+{
+    return glm::vec3(src[0], src[1], src[2]);
+}
+
+}  // namespace
+
+Meshlets buildMeshlets(std::span<const uint16_t> indices, size_t vertexCount, size_t maxVertices, size_t maxTriangles)
+{
+    return build(indices, vertexCount, maxVertices, maxTriangles);
+}
+
+Meshlets buildMeshlets(std::span<const uint32_t> indices, size_t vertexCount, size_t maxVertices, size_t maxTriangles)
+{
+    return build(indices, vertexCount, maxVertices, maxTriangles);
+}
+
+void computeMeshletBounds(Meshlets& meshlets, const vertex::Buffer& vertices)
+{
+    const Positions positions(vertices);
+
+    meshlets.bounds.resize(meshlets.meshlets.size());
+    for (size_t i = 0; i < meshlets.meshlets.size(); ++i)
+    {
+        meshlets.bounds[i] = computeBounds(meshlets, meshlets.meshlets[i], positions);
+    }
+}
+
+bool isMeshletBackfacing(const MeshletBounds& bounds, const glm::vec3& cameraPosition) noexcept
+{
+    // Strict, so a degenerate cone never culls, even seen from its apex.
+    const glm::vec3 view = load(bounds.cone_apex) - cameraPosition;
+    return glm::dot(view, load(bounds.cone_axis)) > bounds.cone_cutoff * glm::length(view);
+}
+
+bool isMeshletOutside(const MeshletBounds& bounds, std::span<const glm::vec4, 6> planes) noexcept
+{
+    const glm::vec3 center = load(bounds.center);
+    for (const glm::vec4& plane : planes)
+    {
+        if (glm::dot(glm::vec3(plane.x, plane.y, plane.z), center) + plane.w < -bounds.radius)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace mesh
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "graphics/vertex.h"
+
+#include "shader_header/meshlet_info.h"
+
+namespace mesh
+{
+
+constexpr size_t k_max_meshlet_vertices  = MESHLET_MAX_VERTICES;
+constexpr size_t k_max_meshlet_triangles = MESHLET_MAX_TRIANGLES;
+
+// A cluster of triangles sharing few vertices, laid out like the Meshlet struct of shader_header/meshlet_info.h.
+struct Meshlet
+{
+    uint32_t vertex_offset   = 0;  // First entry in Meshlets::vertices.
+    uint32_t triangle_offset = 0;  // First byte in Meshlets::triangles, a multiple of 4.
+    uint32_t vertex_count    = 0;
+    uint32_t triangle_count  = 0;
+};
+static_assert(sizeof(Meshlet) == 16, "Meshlet must match its std430 layout.");
+
+// Culling data of a meshlet, laid out like the MeshletBounds struct of shader_header/meshlet_info.h: plain floats, as
+// the aligned glm::vec3 is 16 bytes. The meshlet is off-screen when its sphere is, and back-facing when the camera is
+// inside the cone of directions from which every triangle is seen from behind, see isMeshletBackfacing().
+struct MeshletBounds
+{
+    float center[3]    = {};
+    float radius       = 0.0f;
+    float cone_apex[3] = {};
+    float cone_cutoff  = 1.0f;  // Cosine of the view cone half angle; 1 when the normals are too spread to ever cull.
+    float cone_axis[3] = {};
+    float padding      = 0.0f;
+};
+static_assert(sizeof(MeshletBounds) == 48, "MeshletBounds must match its std430 layout.");
+
+// The arrays uploaded by MeshletBuffer. Meshlets index their own vertex list with 8-bit micro-indices, which index the
+// vertex buffer in turn: the index data of a full meshlet is 64 * 4 + 124 * 3 bytes instead of 124 * 3 * 4.
+struct Meshlets
+{
+    std::vector<Meshlet>       meshlets;
+    std::vector<uint32_t>      vertices;   // Vertex buffer index of each meshlet vertex.
+    std::vector<uint8_t>       triangles;  // Three micro-indices per triangle, each meshlet padded to 4 bytes.
+    std::vector<MeshletBounds> bounds;     // By meshlet, empty until computeMeshletBounds().
+};
+
+// Splits a triangle list into meshlets of at most `maxVertices` vertices and `maxTriangles` triangles. Each meshlet
+// grows from a seed triangle by the adjacent triangles that add the fewest new vertices; seeds follow the index order,
+// so run optimizeVertexCache() first for meshlets that are also cache friendly when drawn as triangles.
+//
+//     mesh::Meshlets meshlets = mesh::buildMeshlets(indices, vb.count());
+//     mesh::computeMeshletBounds(meshlets, vb);
+//     auto meshletBuffer      = std::make_unique<MeshletBuffer>(gfx, meshlets);
+Meshlets buildMeshlets(std::span<const uint16_t> indices,
+                       size_t                    vertexCount,
+                       size_t                    maxVertices  = k_max_meshlet_vertices,
+                       size_t                    maxTriangles = k_max_meshlet_triangles);
+Meshlets buildMeshlets(std::span<const uint32_t> indices,
+                       size_t                    vertexCount,
+                       size_t                    maxVertices  = k_max_meshlet_vertices,
+                       size_t                    maxTriangles = k_max_meshlet_triangles);
+
+// Fills `meshlets.bounds` from the Pos3d or Pos3dHalf attribute of the vertices the meshlets index: a Ritter bounding
+// sphere, and a normal cone over the face normals, as the interpolated Normal attribute does not bound which way the
+// triangles face. Throws std::runtime_error if `vertices` has no position.
+void computeMeshletBounds(Meshlets& meshlets, const vertex::Buffer& vertices);
+
+// CPU counterparts of the shader_header/meshlet_info.h tests. `planes` are normalized and point inside the frustum.
+bool isMeshletBackfacing(const MeshletBounds& bounds, const glm::vec3& cameraPosition) noexcept;
+bool isMeshletOutside(const MeshletBounds& bounds, std::span<const glm::vec4, 6> planes) noexcept;
+
+}  // namespace mesh
@@ -0,0 +1,105 @@
+#include "graphics/mesh/vertex_fetch.h"
+#include <cassert>
+#include <cstring>
+
+namespace mesh
+{
+
+namespace
+{
+
+template <typename T>
+std::vector<uint32_t> buildRemap(std::span<const T> indices, size_t vertexCount, size_t& uniqueCount)
+{
+    std::vector<uint32_t> remap(vertexCount, k_unused_vertex);
+    uint32_t              next = 0;
+    for (T index : indices)
+    {
+        assert(index < vertexCount);
+        if (remap[index] == k_unused_vertex)
+        {
+            remap[index] = next++;
+        }
+    }
+    uniqueCount = next;
+    return remap;
+}
+
+template <typename T>
+void remapIndexSpan(std::span<T> indices, std::span<const uint32_t> remap)
+{
+    for (T& index : indices)
+    {
+        assert(remap[index] != k_unused_vertex);
+        index = static_cast<T>(remap[index]);
+    }
+}
+
+template <typename T>
+size_t optimize(vertex::Buffer& vertices, std::span<T> indices)
+{
+    size_t                      uniqueCount = 0;
+    const std::vector<uint32_t> remap       = buildRemap(std::span<const T>(indices), vertices.count(), uniqueCount);
+
+    vertices = remapVertices(vertices, remap, uniqueCount);
+    remapIndexSpan(indices, remap);
+    return uniqueCount;
+}
+
+}  // namespace
+
+size_t optimizeVertexFetch(vertex::Buffer& vertices, std::span<uint16_t> indices)
+{
+    return optimize(vertices, indices);
+}
+
+size_t optimizeVertexFetch(vertex::Buffer& vertices, std::span<uint32_t> indices)
+{
+    return optimize(vertices, indices);
+}
+
+std::vector<uint32_t> buildVertexFetchRemap(std::span<const uint16_t> indices, size_t vertexCount, size_t& uniqueCount)
+{
+    return buildRemap(indices, vertexCount, uniqueCount);
+}
+
+std::vector<uint32_t> buildVertexFetchRemap(std::span<const uint32_t> indices, size_t vertexCount, size_t& uniqueCount)
+{
+    return buildRemap(indices, vertexCount, uniqueCount);
+}
+
+// Stream by stream: each pass reads one source stream sequentially and writes every vertex of its destination stream
+// once, whatever the layout.
+vertex::Buffer remapVertices(const vertex::Buffer& src, std::span<const uint32_t> remap, size_t uniqueCount)
+{
+    assert(remap.size() == src.count());
+
+    vertex::Buffer dst(src.layout());
+    dst.append(uniqueCount);
+    for (uint32_t stream = 0; stream < src.streamCount(); ++stream)
+    {
+        const size_t     stride = src.layout().getStride(stream);
+        const std::byte* from   = src.dataPtr(stream);
+        std::byte*       to     = dst.dataPtr(stream);
+        for (size_t v = 0; v < remap.size(); ++v)
+        {
+            if (remap[v] != k_unused_vertex)
+            {
+                std::memcpy(to + remap[v] * stride, from + v * stride, stride);
+            }
+        }
+    }
+    return dst;
+}
+
+void remapIndices(std::span<uint16_t> indices, std::span<const uint32_t> remap)
+{
+    remapIndexSpan(indices, remap);
+}
+
+void remapIndices(std::span<uint32_t> indices, std::span<const uint32_t> remap)
+{
+    remapIndexSpan(indices, remap);
+}
+
+}  // namespace mesh
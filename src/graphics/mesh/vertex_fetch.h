@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "graphics/vertex.h"
+
+namespace mesh
+{
+
+// Marks vertices that no index references in the remap tables below.
+constexpr uint32_t k_unused_vertex = ~0u;
+
+// Renumbers vertices in the order the index buffer first references them, so the vertex fetch of consecutive
+// triangles reads consecutive memory in every stream. Run it after optimizeVertexCache() and optimizeOverdraw():
+// it keeps the triangle order and only rewrites the indices. Unreferenced vertices are dropped.
+//
+//     mesh::optimizeVertexCache(indices, indices, vb.count());
+//     mesh::optimizeVertexFetch(vb, indices);
+size_t optimizeVertexFetch(vertex::Buffer& vertices, std::span<uint16_t> indices);
+size_t optimizeVertexFetch(vertex::Buffer& vertices, std::span<uint32_t> indices);
+
+// The steps of optimizeVertexFetch(). The remap gives the new index of each old vertex, or k_unused_vertex.
+std::vector<uint32_t> buildVertexFetchRemap(std::span<const uint16_t> indices, size_t vertexCount, size_t& uniqueCount);
+std::vector<uint32_t> buildVertexFetchRemap(std::span<const uint32_t> indices, size_t vertexCount, size_t& uniqueCount);
+
+vertex::Buffer remapVertices(const vertex::Buffer& src, std::span<const uint32_t> remap, size_t uniqueCount);
+
+void remapIndices(std::span<uint16_t> indices, std::span<const uint32_t> remap);
+void remapIndices(std::span<uint32_t> indices, std::span<const uint32_t> remap);
+
+}  // namespace mesh
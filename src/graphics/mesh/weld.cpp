@@ -0,0 +1,220 @@
+#include "graphics/mesh/weld.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <future>
+#include <thread>
+
+namespace mesh
+{
+
+namespace
+{
+
+// Below this many vertices the threads cost more than the hashing they share.
+constexpr size_t k_parallel_min_vertices = 1 << 16;
+
+// Vertex bytes are read 8 at a time; attribute sizes are multiples of 4, so the tail is one 4-byte word at most.
+uint64_t hashWords(const std::byte* data, size_t size, uint64_t hash) noexcept
+{
+    constexpr uint64_t k_multiplier = 0x9e3779b97f4a7c15ull;
+
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (std::rotl(hash, 23) ^ word) * k_multiplier;
+    }
+    for (; i < size; i += 4)
+    {
+        uint32_t word = 0;
+        std::memcpy(&word, data + i, std::min<size_t>(sizeof(word), size - i));
+        hash = (std::rotl(hash, 23) ^ word) * k_multiplier;
+    }
+    return hash;
+}
+
+uint64_t finalize(uint64_t hash) noexcept
+{
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+// Bytes the vertex fetch reads for `format`. Attributes stored as an aligned glm::vec3 are 16 bytes, the last 4 of which
+// glm leaves uninitialised, so they are neither hashed nor compared.
+size_t formatSize(VkFormat format, size_t storageSize) noexcept
+{
+    switch (format)
+    {
+    case VK_FORMAT_R32_UINT:
+    case VK_FORMAT_R16G16_SFLOAT:
+    case VK_FORMAT_R16G16_SNORM:
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_A2B10G10R10_SNORM_PACK32: return 4;
+    case VK_FORMAT_R32G32_SFLOAT:
+    case VK_FORMAT_R16G16B16A16_SFLOAT: return 8;
+    case VK_FORMAT_R32G32B32_SFLOAT: return 12;
+    case VK_FORMAT_R32G32B32A32_SFLOAT: return 16;
+    default: return storageSize;
+    }
+}
+
+class VertexBytes
+{
+public:
+    explicit VertexBytes(const vertex::Buffer& buffer)
+    {
+        const vertex::Layout& layout = buffer.layout();
+        for (size_t i = 0; i < layout.getElementCount(); ++i)
+        {
+            const vertex::Layout::Attribute& attribute = layout.resolve(i);
+            m_attributes.push_back({ buffer.dataPtr(attribute.stream()) + attribute.offset(),
+                                     layout.getStride(attribute.stream()),
+                                     formatSize(attribute.format(), attribute.size()) });
+        }
+    }
+
+    uint64_t hash(size_t vertex) const noexcept
+    {
+        uint64_t hash = 0;
+        for (const AttributeBytes& attribute : m_attributes)
+        {
+            hash = hashWords(attribute.data + vertex * attribute.stride, attribute.size, hash);
+        }
+        return finalize(hash);
+    }
+
+    bool equal(size_t a, size_t b) const noexcept
+    {
+        for (const AttributeBytes& attribute : m_attributes)
+        {
+            if (std::memcmp(attribute.data + a * attribute.stride, attribute.data + b * attribute.stride, attribute.size) != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    struct AttributeBytes
+    {
+        const std::byte* data;    // First vertex.
+        size_t           stride;  // Of its stream.
+        size_t           size;    // Without padding.
+    };
+
+    std::vector<AttributeBytes> m_attributes;
+};
+
+std::vector<uint64_t> hashVertices(const VertexBytes& bytes, size_t count)
+{
+    std::vector<uint64_t> hashes(count);
+    auto                  hashRange = [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i)
+        {
+            hashes[i] = bytes.hash(i);
+        }
+    };
+
+    const size_t threadCount = count < k_parallel_min_vertices ? 1 : std::max(1u, std::thread::hardware_concurrency());
+    if (threadCount == 1)
+    {
+        hashRange(0, count);
+        return hashes;
+    }
+
+    const size_t                   chunk = (count + threadCount - 1) / threadCount;
+    std::vector<std::future<void>> tasks;
+    for (size_t first = chunk; first < count; first += chunk)
+    {
+        tasks.push_back(std::async(std::launch::async, hashRange, first, std::min(first + chunk, count)));
+    }
+    hashRange(0, std::min(chunk, count));
+    for (std::future<void>& task : tasks)
+    {
+        task.get();
+    }
+    return hashes;
+}
+
+}  // namespace
+
+WeldResult weld(const vertex::Buffer& src, std::span<const uint32_t> indices)
+{
+    const size_t vertexCount = src.count();
+    assert(vertexCount < WeldResult::k_unused);
+
+    const VertexBytes           bytes(src);
+    const std::vector<uint64_t> hashes = hashVertices(bytes, vertexCount);
+
+    WeldResult result{ vertex::Buffer(src.layout()), std::vector<uint32_t>(vertexCount, WeldResult::k_unused), {} };
+
+    // Open addressing on source vertex ids, with at least twice as many slots as vertices.
+    const size_t          tableSize = std::bit_ceil(std::max<size_t>(vertexCount * 2, 16));
+    const size_t          mask      = tableSize - 1;
+    std::vector<uint32_t> table(tableSize, WeldResult::k_unused);
+    std::vector<uint32_t> uniques;  // Source vertex of each output vertex.
+
+    auto remapVertex = [&](uint32_t vertex) {
+        if (result.remap[vertex] != WeldResult::k_unused)
+        {
+            return result.remap[vertex];
+        }
+
+        size_t slot = hashes[vertex] & mask;
+        while (table[slot] != WeldResult::k_unused)
+        {
+            const uint32_t other = table[slot];
+            if (hashes[other] == hashes[vertex] && bytes.equal(other, vertex))
+            {
+                return result.remap[vertex] = result.remap[other];
+            }
+            slot = (slot + 1) & mask;
+        }
+
+        table[slot] = vertex;
+        uniques.push_back(vertex);
+        return result.remap[vertex] = static_cast<uint32_t>(uniques.size() - 1);
+    };
+
+    if (indices.empty())
+    {
+        result.indices.resize(vertexCount);
+        for (uint32_t i = 0; i < vertexCount; ++i)
+        {
+            result.indices[i] = remapVertex(i);
+        }
+    }
+    else
+    {
+        result.indices.resize(indices.size());
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            assert(indices[i] < vertexCount);
+            result.indices[i] = remapVertex(indices[i]);
+        }
+    }
+
+    vertex::Buffer& dst = result.vertices;
+    dst.append(uniques.size());
+    for (uint32_t stream = 0; stream < src.streamCount(); ++stream)
+    {
+        const size_t     stride = src.layout().getStride(stream);
+        const std::byte* from   = src.dataPtr(stream);
+        std::byte*       to     = dst.dataPtr(stream);
+        for (size_t i = 0; i < uniques.size(); ++i)
+        {
+            std::memcpy(to + i * stride, from + uniques[i] * stride, stride);
+        }
+    }
+    return result;
+}
+
+}  // namespace mesh
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "graphics/vertex.h"
+
+namespace mesh
+{
+
+struct WeldResult
+{
+    vertex::Buffer        vertices;  // Unique vertices, in the order they are first referenced.
+    std::vector<uint32_t> remap;     // Index in `vertices` of each source vertex, k_unused if nothing references it.
+    std::vector<uint32_t> indices;   // The source triangles, indexing `vertices`.
+
+    static constexpr uint32_t k_unused = ~0u;
+};
+
+// Merges the vertices of `src` whose attributes are bitwise identical. `indices` may be empty for a triangle soup, where
+// every three consecutive vertices are a triangle. Only the bytes of each attribute's format are compared, so padding,
+// such as the fourth float of an aligned glm::vec3, never splits vertices; 0.0 and -0.0 still differ.
+//
+//     mesh::WeldResult welded = mesh::weld(importedSoup);
+//     auto vertexBuffer = std::make_unique<VertexBuffer>(gfx, welded.vertices);
+//     auto indexBuffer  = IndexBuffer::createCompact(gfx, std::span<const uint32_t>(welded.indices));
+WeldResult weld(const vertex::Buffer& src, std::span<const uint32_t> indices = {});
+
+}  // namespace mesh
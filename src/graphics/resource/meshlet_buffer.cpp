@@ -0,0 +1,93 @@
+#include "graphics/resource/meshlet_buffer.h"
+#include <cassert>
+#include <cstring>
+#include <span>
+
+namespace
+{
+// The largest minStorageBufferOffsetAlignment the specification allows, so any device can bind each array.
+constexpr VkDeviceSize k_array_alignment = 256;
+}  // namespace
+
+MeshletBuffer::MeshletBuffer(Graphics& gfx, const mesh::Meshlets& meshlets)
+    : m_count(static_cast<uint32_t>(meshlets.meshlets.size()))
+{
+    assert(!meshlets.meshlets.empty());
+    assert((meshlets.bounds.empty() || meshlets.bounds.size() == meshlets.meshlets.size()) && "Bounds are per meshlet.");
+
+    const std::array<std::span<const std::byte>, k_array_count> arrays = {
+        std::as_bytes(std::span(meshlets.meshlets)),
+        std::as_bytes(std::span(meshlets.vertices)),
+        std::as_bytes(std::span(meshlets.triangles)),
+        std::as_bytes(std::span(meshlets.bounds)),
+    };
+    for (uint32_t i = 0; i < k_array_count; ++i)
+    {
+        m_size       = (m_size + k_array_alignment - 1) / k_array_alignment * k_array_alignment;
+        m_offsets[i] = m_size;
+        m_ranges[i]  = arrays[i].size();
+        m_size      += arrays[i].size();
+    }
+
+    create(gfx,
+           m_size,
+           VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+           m_buffer,
+           m_memory);
+
+
+    VkBuffer       staging_buffer = {};
+    VkDeviceMemory staging_memory = {};
+    try
+    {
+        create(gfx,
+               m_size,
+               VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+               staging_buffer,
+               staging_memory);
+
+        {
+            Mapper<std::byte> map(gfx, staging_memory, m_size, 0);
+            for (uint32_t i = 0; i < k_array_count; ++i)
+            {
+                std::memcpy(&map + m_offsets[i], arrays[i].data(), arrays[i].size());
+            }
+        }
+
+        Buffer::copy(gfx, staging_buffer, m_buffer, m_size);
+
+        vkDestroyBuffer(getDevice(gfx), staging_buffer, nullptr);
+        vkFreeMemory(getDevice(gfx), staging_memory, nullptr);
+    }
+    catch (Graphics::VkException& e)
+    {
+        if (staging_buffer != VK_NULL_HANDLE)
+        {
+            vkDestroyBuffer(getDevice(gfx), staging_buffer, nullptr);
+        }
+        if (staging_memory != VK_NULL_HANDLE)
+        {
+            vkFreeMemory(getDevice(gfx), staging_memory, nullptr);
+        }
+    }
+}
+
+void MeshletBuffer::reset(Graphics& gfx) noexcept
+{
+    if (m_buffer != VK_NULL_HANDLE)
+    {
+        vkDestroyBuffer(getDevice(gfx), m_buffer, nullptr);
+        m_buffer = VK_NULL_HANDLE;
+    }
+    if (m_memory != VK_NULL_HANDLE)
+    {
+        vkFreeMemory(getDevice(gfx), m_memory, nullptr);
+        m_memory = VK_NULL_HANDLE;
+    }
+    m_size  = 0;
+    m_count = 0;
+    m_offsets.fill(0);
+    m_ranges.fill(0);
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <array>
+
+#include "graphics/resource/buffer.h"
+
+#include "graphics/mesh/meshlet.h"
+
+// The arrays of mesh::Meshlets in one device local storage buffer, read by the cluster culling and mesh shader passes
+// next to the vertex buffer the meshlet vertices index. Each array gets its own descriptor; the bounds one is empty
+// unless mesh::computeMeshletBounds() ran.
+class MeshletBuffer : public Buffer
+{
+public:
+    MeshletBuffer(Graphics& gfx, const mesh::Meshlets& meshlets);
+    MeshletBuffer(const MeshletBuffer&)            = delete;
+    MeshletBuffer& operator=(const MeshletBuffer&) = delete;
+
+public:
+    uint32_t getCount() const noexcept { return m_count; }
+
+    VkDescriptorBufferInfo makeMeshletInfo() const noexcept { return makeInfo(k_meshlets); }
+    VkDescriptorBufferInfo makeVertexInfo() const noexcept { return makeInfo(k_vertices); }
+    VkDescriptorBufferInfo makeTriangleInfo() const noexcept { return makeInfo(k_triangles); }
+    VkDescriptorBufferInfo makeBoundsInfo() const noexcept { return makeInfo(k_bounds); }
+
+    bool hasBounds() const noexcept { return m_ranges[k_bounds] != 0; }
+
+    void reset(Graphics& gfx) noexcept;
+
+private:
+    enum Array : uint32_t
+    {
+        k_meshlets,
+        k_vertices,
+        k_triangles,
+        k_bounds,
+        k_array_count
+    };
+
+    VkDescriptorBufferInfo makeInfo(Array array) const noexcept
+    {
+        return VkDescriptorBufferInfo{ .buffer = m_buffer, .offset = m_offsets[array], .range = m_ranges[array] };
+    }
+
+protected:
+    VkDeviceSize   m_size   = 0;
+    VkBuffer       m_buffer = VK_NULL_HANDLE;
+    VkDeviceMemory m_memory = VK_NULL_HANDLE;
+    uint32_t       m_count  = 0;
+
+    std::array<VkDeviceSize, k_array_count> m_offsets = {};
+    std::array<VkDeviceSize, k_array_count> m_ranges  = {};
+};
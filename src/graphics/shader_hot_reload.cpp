@@ -0,0 +1,158 @@
+#include "graphics/shader_hot_reload.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+
+#include "utils/log.h"
+
+#include "graphics/vulkan_helper/pipeline_compiler.h"
+#include "graphics/vulkan_helper/shader_library.h"
+
+ShaderHotReload::ShaderHotReload(vulkan::ShaderLibrary&                    library,
+                                 vulkan::PipelineCompiler&                 compiler,
+                                 const std::filesystem::path&              source_dir,
+                                 const std::filesystem::path&              binary_dir,
+                                 const std::vector<std::filesystem::path>& include_dirs)
+    : m_library(library)
+    , m_compiler(compiler)
+    , m_source_dir(source_dir.lexically_normal())
+    , m_binary_dir(binary_dir.lexically_normal())
+    , m_include_dirs(include_dirs)
+{
+    for (std::filesystem::path& dir : m_include_dirs)
+    {
+        dir = dir.lexically_normal();
+    }
+
+    std::vector<std::filesystem::path> watched = { m_source_dir, m_binary_dir };
+    watched.insert(watched.end(), m_include_dirs.begin(), m_include_dirs.end());
+    for (const std::filesystem::path& dir : watched)
+    {
+        if (!m_watcher.addDirectory(dir))
+        {
+            LogWarn("Shader hot reload: cannot watch {}.", dir.string());
+        }
+    }
+}
+
+ShaderHotReload::~ShaderHotReload() noexcept
+{
+    for (Compilation& compilation : m_compilations)
+    {
+        compilation.exit_code.wait();
+    }
+}
+
+void ShaderHotReload::update()
+{
+    for (const std::filesystem::path& path : m_watcher.poll())
+    {
+        const std::filesystem::path dir = path.parent_path();
+        if (dir == m_binary_dir && path.extension() == ".spv")
+        {
+            reload(path);
+        }
+        else if (dir == m_source_dir && path.extension() == ".glsl")
+        {
+            compile(path);
+        }
+        else
+        {
+            for (const std::filesystem::path& source : findIncludingSources(path))
+            {
+                compile(source);
+            }
+        }
+    }
+
+    auto it = m_compilations.begin();
+    while (it != m_compilations.end())
+    {
+        if (it->exit_code.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            ++it;
+            continue;
+        }
+
+        // The new binary is picked up by the watcher, like any other change in m_binary_dir.
+        if (it->exit_code.get() != 0)
+        {
+            LogError("Shader hot reload: failed to compile {}.", it->source.string());
+        }
+
+        const bool                  outdated = it->outdated;
+        const std::filesystem::path source   = it->source;
+        it                                   = m_compilations.erase(it);
+        if (outdated)
+        {
+            compile(source);
+        }
+    }
+}
+
+void ShaderHotReload::compile(const std::filesystem::path& source)
+{
+    for (Compilation& compilation : m_compilations)
+    {
+        if (compilation.source == source)
+        {
+            compilation.outdated = true;
+            return;
+        }
+    }
+
+    // "test.vert.glsl" is compiled as a vertex shader into "test.vert.spv".
+    const std::string stage = source.stem().extension().string();
+    if (stage.size() < 2)
+    {
+        LogWarn("Shader hot reload: no stage in the name of {}.", source.string());
+        return;
+    }
+
+    std::string command = std::string(k_compiler) + " -V -S " + stage.substr(1);
+    for (const std::filesystem::path& dir : m_include_dirs)
+    {
+        command += " -I\"" + dir.string() + "\"";
+    }
+    command += " -o \"" + (m_binary_dir / source.stem()).string() + ".spv\"";
+    command += " \"" + source.string() + "\"";
+
+    LogInfo("Shader hot reload: compiling {}.", source.string());
+    m_compilations.push_back({ source, std::async(std::launch::async, [command] { return std::system(command.c_str()); }) });
+}
+
+void ShaderHotReload::reload(const std::filesystem::path& binary)
+{
+    for (const vulkan::ShaderLibrary::Change& change : m_library.reload(binary))
+    {
+        const uint32_t count = m_compiler.rebuildShader(change.oldHash, change.module, change.hash);
+        LogInfo("Shader hot reload: {} changed, rebuilding {} pipeline(s).", binary.string(), count);
+    }
+}
+
+std::vector<std::filesystem::path> ShaderHotReload::findIncludingSources(const std::filesystem::path& header) const
+{
+    const std::string include = "\"" + header.filename().string() + "\"";
+
+    std::vector<std::filesystem::path> sources;
+    std::error_code                    ec;
+    for (const auto& entry : std::filesystem::directory_iterator(m_source_dir, ec))
+    {
+        if (entry.path().extension() != ".glsl")
+        {
+            continue;
+        }
+
+        std::ifstream file(entry.path());
+        std::string   line;
+        while (std::getline(file, line))
+        {
+            if (line.find("#include") != std::string::npos && line.find(include) != std::string::npos)
+            {
+                sources.push_back(entry.path().lexically_normal());
+                break;
+            }
+        }
+    }
+    return sources;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <filesystem>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "utils/file_watcher.h"
+
+namespace vulkan
+{
+class PipelineCompiler;
+class ShaderLibrary;
+}  // namespace vulkan
+
+// Recompiles and reloads shaders while the application runs. A GLSL source that changes is recompiled with
+// glslangValidator on a background thread; a header that changes recompiles the sources including it. When a SPIR-V
+// binary changes, the shader library reloads it and the pipeline compiler rebuilds the pipelines using it in the
+// background. The old pipelines are used until the new ones are collected at the beginning of a frame.
+class ShaderHotReload
+{
+public:
+    static constexpr const char* k_compiler = "glslangValidator";
+
+public:
+    ShaderHotReload(vulkan::ShaderLibrary&                    library,
+                    vulkan::PipelineCompiler&                 compiler,
+                    const std::filesystem::path&              source_dir,
+                    const std::filesystem::path&              binary_dir,
+                    const std::vector<std::filesystem::path>& include_dirs);
+    ShaderHotReload(const ShaderHotReload&)            = delete;
+    ShaderHotReload& operator=(const ShaderHotReload&) = delete;
+    ~ShaderHotReload() noexcept;
+
+    // Call once per frame from the render thread, before PipelineCompiler::collect().
+    void update();
+
+private:
+    struct Compilation
+    {
+        std::filesystem::path source;
+        std::future<int>      exit_code;
+        bool                  outdated = false;  // The source changed again while compiling.
+    };
+
+    void compile(const std::filesystem::path& source);
+    void reload(const std::filesystem::path& binary);
+
+    // Sources of m_source_dir that include `header`, directly.
+    std::vector<std::filesystem::path> findIncludingSources(const std::filesystem::path& header) const;
+
+    vulkan::ShaderLibrary&    m_library;
+    vulkan::PipelineCompiler& m_compiler;
+
+    std::filesystem::path              m_source_dir;
+    std::filesystem::path              m_binary_dir;
+    std::vector<std::filesystem::path> m_include_dirs;
+
+    FileWatcher              m_watcher;
+    std::vector<Compilation> m_compilations;
+};
@@ -1,6 +1,14 @@
 #pragma once
+#include <algorithm>
+#include <array>
 #include <type_traits>
 #include <cassert>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <span>
 #include <vector>
 
@@ -12,6 +20,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "graphics/vertex_packing.h"
+
 namespace vertex
 {
 
@@ -24,6 +34,16 @@ namespace vertex
     DEF(Tangent)                                                                                                                           \
     DEF(Bitangent)                                                                                                                         \
     DEF(TexCoords)                                                                                                                         \
+    DEF(Pos3dHalf)                                                                                                                         \
+    DEF(TexCoordsHalf)                                                                                                                     \
+    DEF(NormalOct)                                                                                                                         \
+    DEF(TangentPacked)                                                                                                                     \
+    DEF(Color4Unorm8)                                                                                                                      \
+    DEF(InstanceRow0)                                                                                                                      \
+    DEF(InstanceRow1)                                                                                                                      \
+    DEF(InstanceRow2)                                                                                                                      \
+    DEF(InstanceColor)                                                                                                                     \
+    DEF(InstanceMaterial)                                                                                                                  \
     DEF(Count)
 
 enum class AttributeType
@@ -36,6 +56,9 @@ enum class AttributeType
 class Layout
 {
 public:
+    // Streams are separate vertex buffer bindings, e.g. positions alone in stream 0 for depth-only passes.
+    static constexpr uint32_t k_max_streams = 4;
+
     template <AttributeType>
     struct Map
     {};
@@ -112,6 +135,100 @@ public:
         static constexpr VkFormat k_format    = VK_FORMAT_R32G32_SFLOAT;
     };
 
+    // Compressed counterparts, see vertex_packing.h. Pos3dHalf + NormalOct + TangentPacked + TexCoordsHalf is 20 bytes,
+    // against 72 for Pos3d + Normal + Tangent + Bitangent + TexCoords, whose aligned glm::vec3 take 16 bytes each.
+    template <>
+    struct Map<AttributeType::Pos3dHalf>
+    {
+        using DataType = Half3;
+
+        static constexpr size_t   k_dimension = 4;
+        static constexpr VkFormat k_format    = VK_FORMAT_R16G16B16A16_SFLOAT;
+    };
+
+    template <>
+    struct Map<AttributeType::TexCoordsHalf>
+    {
+        using DataType = Half2;
+
+        static constexpr size_t   k_dimension = 2;
+        static constexpr VkFormat k_format    = VK_FORMAT_R16G16_SFLOAT;
+    };
+
+    template <>
+    struct Map<AttributeType::NormalOct>
+    {
+        using DataType = OctNormal;
+
+        static constexpr size_t   k_dimension = 2;
+        static constexpr VkFormat k_format    = VK_FORMAT_R16G16_SNORM;
+    };
+
+    template <>
+    struct Map<AttributeType::TangentPacked>
+    {
+        using DataType = PackedTangent;
+
+        static constexpr size_t   k_dimension = 4;
+        static constexpr VkFormat k_format    = VK_FORMAT_A2B10G10R10_SNORM_PACK32;
+    };
+
+    template <>
+    struct Map<AttributeType::Color4Unorm8>
+    {
+        using DataType = Unorm8x4;
+
+        static constexpr size_t   k_dimension = 4;
+        static constexpr VkFormat k_format    = VK_FORMAT_R8G8B8A8_UNORM;
+    };
+
+    // Per-instance attributes, for streams appended with VK_VERTEX_INPUT_RATE_INSTANCE. The rows are those of the
+    // model matrix transposed to 3x4, whose fourth row is always (0, 0, 0, 1): 48 bytes per instance instead of 64.
+    template <>
+    struct Map<AttributeType::InstanceRow0>
+    {
+        using DataType = glm::vec4;
+
+        static constexpr size_t   k_dimension = 4;
+        static constexpr VkFormat k_format    = VK_FORMAT_R32G32B32A32_SFLOAT;
+    };
+
+    template <>
+    struct Map<AttributeType::InstanceRow1>
+    {
+        using DataType = glm::vec4;
+
+        static constexpr size_t   k_dimension = 4;
+        static constexpr VkFormat k_format    = VK_FORMAT_R32G32B32A32_SFLOAT;
+    };
+
+    template <>
+    struct Map<AttributeType::InstanceRow2>
+    {
+        using DataType = glm::vec4;
+
+        static constexpr size_t   k_dimension = 4;
+        static constexpr VkFormat k_format    = VK_FORMAT_R32G32B32A32_SFLOAT;
+    };
+
+    template <>
+    struct Map<AttributeType::InstanceColor>
+    {
+        using DataType = Unorm8x4;
+
+        static constexpr size_t   k_dimension = 4;
+        static constexpr VkFormat k_format    = VK_FORMAT_R8G8B8A8_UNORM;
+    };
+
+    template <>
+    struct Map<AttributeType::InstanceMaterial>
+    {
+        using DataType = uint32_t;
+
+        static constexpr size_t   k_dimension = 1;
+        static constexpr VkFormat k_format    = VK_FORMAT_R32_UINT;
+    };
+
     template <>
     struct Map<AttributeType::Count>
     {
@@ -159,32 +276,59 @@ public:
         };
 
     public:
-        Attribute(AttributeType type, size_t offset)
+        Attribute(AttributeType type, size_t offset, uint32_t stream = 0)
             : m_type(type)
             , m_offset(offset)
+            , m_size(visit<SizeOf>(type))
+            , m_format(visit<Format>(type))
+            , m_stream(stream)
         {}
 
         AttributeType type() const noexcept { return m_type; }
 
-        size_t   size() const noexcept { return visit<SizeOf>(m_type); }
-        size_t   offset() const noexcept { return m_offset; }
-        size_t   offsetAfter() const noexcept { return m_offset + size(); }
+        uint32_t stream() const noexcept { return m_stream; }
+        size_t   size() const noexcept { return m_size; }
+        size_t   offset() const noexcept { return m_offset; }  // Within its stream.
+        size_t   offsetAfter() const noexcept { return m_offset + m_size; }
         size_t   dimension() const noexcept { return visit<Dimension>(m_type); }
-        VkFormat format() const noexcept { return visit<Format>(m_type); }
+        VkFormat format() const noexcept { return m_format; }
 
     private:
         AttributeType m_type;
         size_t        m_offset;
+        size_t        m_size;  // Cached: `visit()` is a switch over every attribute type.
+        VkFormat      m_format;
+        uint32_t      m_stream;
     };
 
 public:
     Layout() noexcept = default;
 
-    Layout& append(AttributeType type) noexcept
+    // Streams are numbered from 0 without gaps: `stream` is at most getStreamCount(). The input rate is that of the
+    // stream, set by its first attribute: a vertex::Buffer has a single count, so per-instance streams usually go in a
+    // layout of their own, combined with the vertex layout through the `binding` and `location` of the descriptions.
+    Layout& append(AttributeType type, uint32_t stream = 0, VkVertexInputRate rate = VK_VERTEX_INPUT_RATE_VERTEX) noexcept
     {
+        assert(stream < k_max_streams && stream <= getStreamCount());
+        assert((stream == getStreamCount() || m_input_rates[stream] == rate) && "Streams have a single input rate.");
         if (!hasElement(type))
         {
-            m_elements.emplace_back(type, getStride());
+            if (stream == getStreamCount())
+            {
+                m_strides.push_back(0);
+                m_input_rates.push_back(rate);
+            }
+
+            const size_t index = m_elements.size();
+            m_elements.emplace_back(type, m_strides[stream], stream);
+            m_indices[static_cast<size_t>(type)] = static_cast<uint8_t>(index);
+            m_strides[stream]                    = m_elements.back().offsetAfter();
+
+            VkVertexInputAttributeDescription& desc = m_attribute_descs.emplace_back();
+            desc.location                           = static_cast<uint32_t>(index);
+            desc.binding                            = stream;
+            desc.format                             = m_elements.back().format();
+            desc.offset                             = static_cast<uint32_t>(m_elements.back().offset());
         }
         return *this;
     }
@@ -192,70 +336,222 @@ public:
     template <AttributeType AT>
     const Attribute& resolve() const noexcept
     {
-        for (const Attribute& e : m_elements)
+        static_assert(AT != AttributeType::Count);
+        assert(hasElement(AT) && "Cannot find element type in this Vertex type.");
+        return m_elements[m_indices[static_cast<size_t>(AT)]];
+    }
+    const Attribute& resolve(AttributeType type) const noexcept
+    {
+        assert(hasElement(type) && "Cannot find element type in this Vertex type.");
+        return m_elements[m_indices[static_cast<size_t>(type)]];
+    }
+    const Attribute& resolve(size_t i) const noexcept { return m_elements[i]; }
+
+    size_t   getElementCount() const noexcept { return m_elements.size(); }
+    uint32_t getStreamCount() const noexcept { return static_cast<uint32_t>(m_strides.size()); }
+    size_t   getStride(uint32_t stream = 0) const noexcept { return stream < m_strides.size() ? m_strides[stream] : 0; }
+
+    VkVertexInputRate getInputRate(uint32_t stream = 0) const noexcept
+    {
+        return stream < m_input_rates.size() ? m_input_rates[stream] : VK_VERTEX_INPUT_RATE_VERTEX;
+    }
+
+    bool hasElement(AttributeType type) const noexcept { return m_indices[static_cast<size_t>(type)] != k_no_element; }
+
+    // Stream i uses binding `binding + i`, attribute i location `location + i`.
+    void getAttributeDescs(uint32_t binding, std::vector<VkVertexInputAttributeDescription>& descs, uint32_t location = 0) const
+    {
+        for (VkVertexInputAttributeDescription desc : m_attribute_descs)
         {
-            if (e.type() == AT)
-            {
-                return e;
-            }
+            desc.binding  += binding;
+            desc.location += location;
+            descs.push_back(desc);
         }
-        assert(false && "Cannot find element type in this Vertex type.");
-        return m_elements.front();
     }
-    const Attribute& resolve(size_t i) const noexcept { return m_elements[i]; }
 
-    size_t getElementCount() const noexcept { return m_elements.size(); }
-    size_t getStride() const noexcept { return m_elements.empty() ? 0 : m_elements.back().offsetAfter(); }
+    // Built by `append()`, with stream i on binding i.
+    std::span<const VkVertexInputAttributeDescription> getAttributeDescs() const noexcept { return m_attribute_descs; }
+
+    VkVertexInputBindingDescription getBindingDesc(uint32_t binding, uint32_t stream = 0) const
+    {
+        VkVertexInputBindingDescription desc{};
+        desc.binding   = binding;
+        desc.stride    = (uint32_t)getStride(stream);
+        desc.inputRate = getInputRate(stream);
+
+        return desc;
+    }
+
+    // One description per stream, from `binding` on.
+    void getBindingDescs(uint32_t binding, std::vector<VkVertexInputBindingDescription>& descs) const
+    {
+        for (uint32_t stream = 0; stream < getStreamCount(); ++stream)
+        {
+            descs.push_back(getBindingDesc(binding + stream, stream));
+        }
+    }
+
+    Attribute operator[](size_t idx) const { return m_elements[idx]; }
+
+private:
+    static constexpr uint8_t k_no_element = 0xff;
+
+    // Count has a slot too: it is never appended, so hasElement(Count) is false.
+    using IndexTable = std::array<uint8_t, static_cast<size_t>(AttributeType::Count) + 1>;
+
+    static constexpr IndexTable makeEmptyIndices() noexcept
+    {
+        IndexTable indices{};
+        indices.fill(k_no_element);
+        return indices;
+    }
+
+private:
+    IndexTable                                     m_indices = makeEmptyIndices();  // Index in m_elements, by AttributeType.
+    std::vector<Attribute>                         m_elements;
+    std::vector<size_t>                            m_strides;      // By stream.
+    std::vector<VkVertexInputRate>                 m_input_rates;  // By stream.
+    std::vector<VkVertexInputAttributeDescription> m_attribute_descs;
+};
+
+// Compile-time counterpart of Layout: the attributes are template arguments, so the stride, the offsets and the Vulkan
+// descriptions are constants, and StaticLayout<...>::Vertex is a plain struct whose `attr<AT>()` is a store at a fixed
+// offset. Attributes keep their declaration order but are aligned like struct members, so an aligned glm::vec3 may be
+// padded where Layout would pack it: describe the pipeline with this layout's own getAttributeDescs()/getBindingDesc().
+//
+//     using TestLayout = vertex::StaticLayout<vertex::AttributeType::Pos3d, vertex::AttributeType::TexCoords>;
+//
+//     std::vector<TestLayout::Vertex> vertices(count);
+//     vertices[i].attr<vertex::AttributeType::Pos3d>() = { 1.0f, 0.0f, 0.0f };
+template <AttributeType... ATs>
+class StaticLayout
+{
+public:
+    template <AttributeType AT>
+    using DataType = typename Layout::Map<AT>::DataType;
+
+    static constexpr size_t k_count = sizeof...(ATs);
+
+private:
+    static constexpr std::array<AttributeType, k_count> k_types   = { ATs... };
+    static constexpr std::array<size_t, k_count>        k_sizes   = { sizeof(DataType<ATs>)... };
+    static constexpr std::array<VkFormat, k_count>      k_formats = { Layout::Map<ATs>::k_format... };
+
+    static constexpr size_t alignUp(size_t value, size_t alignment) noexcept { return (value + alignment - 1) / alignment * alignment; }
+
+    static constexpr std::array<size_t, k_count> makeOffsets() noexcept
+    {
+        constexpr std::array<size_t, k_count> alignments = { alignof(DataType<ATs>)... };
+
+        std::array<size_t, k_count> offsets{};
+        size_t                      end = 0;
+        for (size_t i = 0; i < k_count; ++i)
+        {
+            offsets[i] = alignUp(end, alignments[i]);
+            end        = offsets[i] + k_sizes[i];
+        }
+        return offsets;
+    }
 
-    bool hasElement(AttributeType type) const noexcept
+    static constexpr bool hasUniqueTypes() noexcept
     {
-        for (const auto& e : m_elements)
+        for (size_t i = 0; i < k_count; ++i)
         {
-            if (e.type() == type)
+            for (size_t j = i + 1; j < k_count; ++j)
             {
-                return true;
+                if (k_types[i] == k_types[j])
+                {
+                    return false;
+                }
             }
         }
-        return false;
+        return true;
     }
 
-    void getAttributeDescs(uint32_t binding, std::vector<VkVertexInputAttributeDescription>& descs) const
+    static_assert(k_count > 0, "A vertex needs at least one attribute.");
+    static_assert(((ATs != AttributeType::Count) && ...), "AttributeType::Count is not an attribute.");
+    static_assert(hasUniqueTypes(), "Each attribute type may appear once.");
+
+public:
+    static constexpr size_t                      k_alignment = std::max({ alignof(DataType<ATs>)... });
+    static constexpr std::array<size_t, k_count> k_offsets   = makeOffsets();
+    static constexpr size_t                      k_stride    = alignUp(k_offsets.back() + k_sizes.back(), k_alignment);
+
+    template <AttributeType AT>
+    static constexpr bool hasElement() noexcept
     {
-        for (size_t i = 0, n = m_elements.size(); i < n; ++i)
+        return ((AT == ATs) || ...);
+    }
+
+    template <AttributeType AT>
+    static constexpr size_t indexOf() noexcept
+    {
+        static_assert(hasElement<AT>(), "Cannot find element type in this Vertex type.");
+        size_t i = 0;
+        while (k_types[i] != AT)
+        {
+            ++i;
+        }
+        return i;
+    }
+
+    template <AttributeType AT>
+    static constexpr size_t offsetOf() noexcept
+    {
+        return k_offsets[indexOf<AT>()];
+    }
+
+    // Locations follow the declaration order, like Layout::getAttributeDescs().
+    static constexpr std::array<VkVertexInputAttributeDescription, k_count> getAttributeDescs(uint32_t binding) noexcept
+    {
+        std::array<VkVertexInputAttributeDescription, k_count> descs{};
+        for (size_t i = 0; i < k_count; ++i)
         {
-            size_t   dimension = m_elements[i].dimension();
-            VkFormat format    = m_elements[i].format();
-            size_t   offset    = m_elements[i].offset();
-
-            auto& desc    = descs.emplace_back();
-            desc.location = static_cast<uint32_t>(i);
-            desc.binding  = binding;
-            desc.format   = format;
-            desc.offset   = offset;
+            descs[i].location = static_cast<uint32_t>(i);
+            descs[i].binding  = binding;
+            descs[i].format   = k_formats[i];
+            descs[i].offset   = static_cast<uint32_t>(k_offsets[i]);
         }
+        return descs;
     }
 
-    VkVertexInputBindingDescription getBindingDesc(uint32_t binding) const
+    static constexpr VkVertexInputBindingDescription getBindingDesc(uint32_t          binding,
+                                                                    VkVertexInputRate rate = VK_VERTEX_INPUT_RATE_VERTEX) noexcept
     {
         VkVertexInputBindingDescription desc{};
         desc.binding   = binding;
-        desc.stride    = (uint32_t)getStride();
-        desc.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
+        desc.stride    = static_cast<uint32_t>(k_stride);
+        desc.inputRate = rate;
         return desc;
     }
 
-    Attribute operator[](size_t idx) const { return m_elements[idx]; }
+    struct Vertex
+    {
+        template <AttributeType AT>
+        DataType<AT>& attr() noexcept
+        {
+            return *std::launder(reinterpret_cast<DataType<AT>*>(m_data + offsetOf<AT>()));
+        }
 
-private:
-    std::vector<Attribute> m_elements;
+        template <AttributeType AT>
+        const DataType<AT>& attr() const noexcept
+        {
+            return *std::launder(reinterpret_cast<const DataType<AT>*>(m_data + offsetOf<AT>()));
+        }
+
+        alignas(k_alignment) std::byte m_data[k_stride];
+    };
+    static_assert(sizeof(Vertex) == k_stride && alignof(Vertex) == k_alignment);
 };
 
 class Vertex
 {
 public:
-    Vertex(std::byte* data, const Layout& layout) noexcept
-        : m_data_ref(data)
+    using StreamPointers = std::array<std::byte*, Layout::k_max_streams>;
+
+    // `streams` point to this vertex in each stream of `layout`.
+    Vertex(const StreamPointers& streams, const Layout& layout) noexcept
+        : m_streams_ref(streams)
         , m_layout_ref(layout)
     {}
     Vertex(const Vertex&)            = default;
@@ -265,7 +561,7 @@ public:
     void setAttribute(size_t i, T&& val) noexcept
     {
         const auto& element = m_layout_ref.resolve(i);
-        auto        attrib  = m_data_ref + element.offset();
+        auto        attrib  = m_streams_ref[element.stream()] + element.offset();
 
         Layout::visit<SetAttrb>(element.type(), this, attrib, std::forward<T>(val));
     }
@@ -287,7 +583,8 @@ public:
     template <AttributeType AT>
     auto& attr() noexcept
     {
-        auto attrib = m_data_ref + m_layout_ref.resolve<AT>().offset();
+        const auto& element = m_layout_ref.resolve<AT>();
+        auto        attrib  = m_streams_ref[element.stream()] + element.offset();
         return *reinterpret_cast<typename Layout::Map<AT>::DataType*>(attrib);
     }
 
@@ -310,8 +607,8 @@ private:
     }
 
 private:
-    std::byte*    m_data_ref = nullptr;
-    const Layout& m_layout_ref;
+    StreamPointers m_streams_ref{};
+    const Layout&  m_layout_ref;
 };
 
 class ConstVertex
@@ -331,11 +628,143 @@ private:
     Vertex m_vertex;
 };
 
+// Strided range over one attribute of a Buffer, e.g. every position of an interleaved stream. Its iterators are random
+// access, so std algorithms and ranges work on it directly:
+//
+//     auto positions = vb.attributeView<vertex::AttributeType::Pos3d>();
+//     std::ranges::transform(positions, positions.begin(), [&](const glm::vec3& p) { return p * scale; });
+template <typename T>
+class AttributeView
+{
+public:
+    using Byte = std::conditional_t<std::is_const_v<T>, const std::byte, std::byte>;
+
+    class Iterator
+    {
+    public:
+        using iterator_concept  = std::random_access_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = std::remove_cv_t<T>;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = T*;
+        using reference         = T&;
+
+        Iterator() noexcept = default;
+        Iterator(Byte* ptr, difference_type stride) noexcept
+            : m_ptr(ptr)
+            , m_stride(stride)
+        {}
+
+        T& operator*() const noexcept { return *reinterpret_cast<T*>(m_ptr); }
+        T* operator->() const noexcept { return reinterpret_cast<T*>(m_ptr); }
+        T& operator[](difference_type n) const noexcept { return *reinterpret_cast<T*>(m_ptr + n * m_stride); }
+
+        Iterator& operator++() noexcept
+        {
+            m_ptr += m_stride;
+            return *this;
+        }
+        Iterator& operator--() noexcept
+        {
+            m_ptr -= m_stride;
+            return *this;
+        }
+        Iterator operator++(int) noexcept
+        {
+            Iterator it = *this;
+            m_ptr += m_stride;
+            return it;
+        }
+        Iterator operator--(int) noexcept
+        {
+            Iterator it = *this;
+            m_ptr -= m_stride;
+            return it;
+        }
+        Iterator& operator+=(difference_type n) noexcept
+        {
+            m_ptr += n * m_stride;
+            return *this;
+        }
+        Iterator& operator-=(difference_type n) noexcept
+        {
+            m_ptr -= n * m_stride;
+            return *this;
+        }
+
+        friend Iterator        operator+(Iterator it, difference_type n) noexcept { return it += n; }
+        friend Iterator        operator+(difference_type n, Iterator it) noexcept { return it += n; }
+        friend Iterator        operator-(Iterator it, difference_type n) noexcept { return it -= n; }
+        friend difference_type operator-(const Iterator& a, const Iterator& b) noexcept { return (a.m_ptr - b.m_ptr) / a.m_stride; }
+
+        friend bool                 operator==(const Iterator& a, const Iterator& b) noexcept { return a.m_ptr == b.m_ptr; }
+        friend std::strong_ordering operator<=>(const Iterator& a, const Iterator& b) noexcept { return a.m_ptr <=> b.m_ptr; }
+
+    private:
+        Byte*           m_ptr    = nullptr;
+        difference_type m_stride = 0;
+    };
+
+    AttributeView(Byte* data, size_t stride, size_t count) noexcept
+        : m_data(data)
+        , m_stride(stride)
+        , m_count(count)
+    {}
+
+    Iterator begin() const noexcept { return { m_data, static_cast<std::ptrdiff_t>(m_stride) }; }
+    Iterator end() const noexcept { return begin() + static_cast<std::ptrdiff_t>(m_count); }
+
+    T& operator[](size_t i) const noexcept
+    {
+        assert(i < m_count);
+        return *reinterpret_cast<T*>(m_data + i * m_stride);
+    }
+
+    size_t size() const noexcept { return m_count; }
+    bool   empty() const noexcept { return m_count == 0; }
+    size_t stride() const noexcept { return m_stride; }  // In bytes.
+
+private:
+    Byte*  m_data   = nullptr;
+    size_t m_stride = 0;
+    size_t m_count  = 0;
+};
+
+// std::allocator whose default construction leaves bytes uninitialised, so Buffer::append() does not clear storage
+// that is about to be overwritten.
+template <typename T>
+struct UninitializedAllocator : std::allocator<T>
+{
+    template <typename U>
+    struct rebind
+    {
+        using other = UninitializedAllocator<U>;
+    };
+
+    UninitializedAllocator() noexcept = default;
+    template <typename U>
+    UninitializedAllocator(const UninitializedAllocator<U>&) noexcept
+    {}
+
+    template <typename U>
+    void construct(U* ptr) noexcept(std::is_nothrow_default_constructible_v<U>)
+    {
+        ::new (static_cast<void*>(ptr)) U;
+    }
+    template <typename U, typename... Args>
+    void construct(U* ptr, Args&&... args)
+    {
+        ::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+    }
+};
+
+// One byte array per stream of the layout; a single-stream layout gives the usual interleaved buffer.
 class Buffer
 {
 public:
     Buffer(Layout layout, size_t count = 0) noexcept
         : m_layout(std::move(layout))
+        , m_streams(m_layout.getStreamCount())
     {
         resize(count);
     }
@@ -344,36 +773,97 @@ public:
     Buffer(Buffer&&)                 = default;
     Buffer& operator=(Buffer&&)      = default;
 
-    std::span<const std::byte> data() const noexcept { return m_data; }
-    const std::byte*           dataPtr() const noexcept { return m_data.data(); }
+    std::span<const std::byte> data(uint32_t stream = 0) const noexcept { return m_streams[stream]; }
+    const std::byte*           dataPtr(uint32_t stream = 0) const noexcept { return m_streams[stream].data(); }
+    std::byte*                 dataPtr(uint32_t stream = 0) noexcept { return m_streams[stream].data(); }
     const Layout&              layout() const noexcept { return m_layout; }
 
-    size_t count() const noexcept { return m_data.size() / m_layout.getStride(); }
-    size_t sizeOf() const noexcept { return m_data.size(); }
+    uint32_t streamCount() const noexcept { return static_cast<uint32_t>(m_streams.size()); }
+    size_t   count() const noexcept { return m_count; }
+    size_t   sizeOf(uint32_t stream = 0) const noexcept { return m_streams[stream].size(); }
 
+    // Grows to `size` vertices, the new ones zeroed.
     void resize(size_t size)
     {
-        const size_t curr_count = count();
-        if (curr_count < size)
+        if (m_count < size)
         {
-            m_data.resize(m_data.size() + m_layout.getStride() * (size - curr_count));
+            for (uint32_t stream = 0; stream < streamCount(); ++stream)
+            {
+                m_streams[stream].resize(m_layout.getStride(stream) * size, std::byte{ 0 });
+            }
+            m_count = size;
+        }
+    }
+
+    // Adds `count` uninitialised vertices, to be written with fill() or attributeView(). Returns the index of the first.
+    size_t append(size_t count)
+    {
+        const size_t first = m_count;
+        for (uint32_t stream = 0; stream < streamCount(); ++stream)
+        {
+            m_streams[stream].resize(m_layout.getStride(stream) * (first + count));
+        }
+        m_count += count;
+        return first;
+    }
+
+    template <AttributeType AT>
+    AttributeView<typename Layout::Map<AT>::DataType> attributeView() noexcept
+    {
+        const Layout::Attribute& attribute = m_layout.resolve<AT>();
+        return { dataPtr(attribute.stream()) + attribute.offset(), m_layout.getStride(attribute.stream()), m_count };
+    }
+
+    template <AttributeType AT>
+    AttributeView<const typename Layout::Map<AT>::DataType> attributeView() const noexcept
+    {
+        const Layout::Attribute& attribute = m_layout.resolve<AT>();
+        return { dataPtr(attribute.stream()) + attribute.offset(), m_layout.getStride(attribute.stream()), m_count };
+    }
+
+    // Writes `values` to vertices [first, first + values.size()): a single memcpy when the attribute is alone in its stream.
+    template <AttributeType AT>
+    void fill(std::span<const typename Layout::Map<AT>::DataType> values, size_t first = 0) noexcept
+    {
+        using DataType = typename Layout::Map<AT>::DataType;
+        static_assert(std::is_trivially_copyable_v<DataType>);
+        assert(first + values.size() <= m_count);
+
+        const Layout::Attribute& attribute = m_layout.resolve<AT>();
+        const size_t             stride    = m_layout.getStride(attribute.stream());
+
+        std::byte* dst = dataPtr(attribute.stream()) + attribute.offset() + first * stride;
+        if (stride == sizeof(DataType))
+        {
+            std::memcpy(dst, values.data(), values.size_bytes());
+            return;
+        }
+        for (const DataType& value : values)
+        {
+            std::memcpy(dst, &value, sizeof(DataType));
+            dst += stride;
         }
     }
 
     Vertex front()
     {
-        assert(m_data.size() != 0);
-        return Vertex{ m_data.data(), m_layout };
+        assert(m_count != 0);
+        return (*this)[0];
     }
     Vertex back()
     {
-        assert(m_data.size() != 0);
-        return Vertex{ m_data.data() + sizeOf() - m_layout.getStride(), m_layout };
+        assert(m_count != 0);
+        return (*this)[m_count - 1];
     }
     Vertex operator[](size_t i)
     {
-        assert(m_data.size() != 0);
-        return Vertex{ m_data.data() + m_layout.getStride() * i, m_layout };
+        assert(i < m_count);
+        Vertex::StreamPointers streams{};
+        for (uint32_t stream = 0; stream < streamCount(); ++stream)
+        {
+            streams[stream] = m_streams[stream].data() + m_layout.getStride(stream) * i;
+        }
+        return Vertex{ streams, m_layout };
     }
 
     ConstVertex front() const { return const_cast<Buffer*>(this)->front(); }
@@ -381,8 +871,11 @@ public:
     ConstVertex operator[](size_t i) const { return const_cast<Buffer&>(*this)[i]; }
 
 private:
-    std::vector<std::byte> m_data;
-    Layout                 m_layout;
+    using Stream = std::vector<std::byte, UninitializedAllocator<std::byte>>;
+
+    Layout              m_layout;
+    std::vector<Stream> m_streams;
+    size_t              m_count = 0;
 };
 
 #undef DEFINE_ELEMENT_TYPES
@@ -0,0 +1,269 @@
+#include "graphics/vertex_convert.h"
+#include <stdexcept>
+#include <string>
+
+#include "graphics/vertex_convert_kernels.h"
+
+#if VERTEX_CONVERT_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace vertex
+{
+
+namespace convert
+{
+
+namespace detail
+{
+
+const Kernels& getScalarKernels() noexcept
+{
+    static const Kernels kernels = makeKernels<Scalar>();
+    return kernels;
+}
+
+}  // namespace detail
+
+namespace
+{
+
+#if VERTEX_CONVERT_X86
+struct CpuId
+{
+    uint32_t eax = 0;
+    uint32_t ebx = 0;
+    uint32_t ecx = 0;
+    uint32_t edx = 0;
+};
+
+CpuId cpuid(uint32_t leaf, uint32_t subleaf) noexcept
+{
+    CpuId regs;
+#if defined(_MSC_VER) && !defined(__clang__)
+    int values[4];
+    __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+    regs.eax = static_cast<uint32_t>(values[0]);
+    regs.ebx = static_cast<uint32_t>(values[1]);
+    regs.ecx = static_cast<uint32_t>(values[2]);
+    regs.edx = static_cast<uint32_t>(values[3]);
+#else
+    __cpuid_count(leaf, subleaf, regs.eax, regs.ebx, regs.ecx, regs.edx);
+#endif
+    return regs;
+}
+
+// Register state the OS saves on context switches: AVX needs the SSE (bit 1) and AVX (bit 2) states.
+uint64_t getEnabledXStates() noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _xgetbv(0);
+#else
+    uint32_t lo = 0;
+    uint32_t hi = 0;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+#endif
+}
+#endif
+
+Isa detectIsa() noexcept
+{
+#if VERTEX_CONVERT_X86
+    const uint32_t maxLeaf = cpuid(0, 0).eax;
+    const CpuId    leaf1   = cpuid(1, 0);
+
+    const bool sse41   = (leaf1.ecx & (1u << 19)) != 0;
+    const bool osxsave = (leaf1.ecx & (1u << 27)) != 0;
+    const bool avx     = (leaf1.ecx & (1u << 28)) != 0;
+    if (osxsave && avx && maxLeaf >= 7 && (getEnabledXStates() & 0x6) == 0x6 && (cpuid(7, 0).ebx & (1u << 5)) != 0)
+    {
+        return Isa::Avx2;
+    }
+    if (sse41)
+    {
+        return Isa::Sse41;
+    }
+#endif
+    return Isa::Scalar;
+}
+
+const detail::Kernels& getKernels() noexcept
+{
+    static const detail::Kernels& kernels = []() -> const detail::Kernels& {
+        switch (getIsa())
+        {
+        case Isa::Avx2: return *detail::getAvx2Kernels();
+        case Isa::Sse41: return *detail::getSse41Kernels();
+        default: return detail::getScalarKernels();
+        }
+    }();
+    return kernels;
+}
+
+template <size_t Size>
+void copyFixed(StridedBytes dst, ConstStridedBytes src, size_t count) noexcept
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::memcpy(dst.data + i * dst.stride, src.data + i * src.stride, Size);
+    }
+}
+
+}  // namespace
+
+Isa getIsa() noexcept
+{
+    static const Isa isa = detectIsa();
+    return isa;
+}
+
+void packHalf(StridedBytes dst, ConstStridedBytes src, size_t count, uint32_t components, uint32_t dstComponents) noexcept
+{
+    getKernels().packHalf(dst, src, count, components, dstComponents);
+}
+
+void packUnorm8(StridedBytes dst, ConstStridedBytes src, size_t count, uint32_t components) noexcept
+{
+    getKernels().packUnorm8(dst, src, count, components);
+}
+
+void encodeOctahedral(StridedBytes dst, ConstStridedBytes normals, size_t count) noexcept
+{
+    getKernels().encodeOctahedral(dst, normals, count);
+}
+
+void packTangents(StridedBytes      dst,
+                  ConstStridedBytes tangents,
+                  ConstStridedBytes normals,
+                  ConstStridedBytes bitangents,
+                  size_t            count) noexcept
+{
+    getKernels().packTangents(dst, tangents, normals, bitangents, count);
+}
+
+// A plain copy is bound by memory already: the fixed sizes only let the compiler inline each memcpy.
+void copy(StridedBytes dst, ConstStridedBytes src, size_t count, size_t size) noexcept
+{
+    if (dst.stride == size && src.stride == size)
+    {
+        std::memcpy(dst.data, src.data, count * size);
+        return;
+    }
+
+    switch (size)
+    {
+    case 4: return copyFixed<4>(dst, src, count);
+    case 8: return copyFixed<8>(dst, src, count);
+    case 12: return copyFixed<12>(dst, src, count);
+    case 16: return copyFixed<16>(dst, src, count);
+    default:
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::memcpy(dst.data + i * dst.stride, src.data + i * src.stride, size);
+        }
+    }
+}
+
+}  // namespace convert
+
+namespace
+{
+
+ConstStridedBytes viewOf(const Buffer& buffer, AttributeType type) noexcept
+{
+    const Layout::Attribute& attribute = buffer.layout().resolve(type);
+    return { buffer.dataPtr(attribute.stream()) + attribute.offset(), buffer.layout().getStride(attribute.stream()) };
+}
+
+// Fills `dst` from the float counterpart of `type` in `src`. False if `src` has none.
+bool convertAttribute(const Buffer& src, AttributeType type, StridedBytes dst)
+{
+    using T = AttributeType;
+
+    const Layout& layout = src.layout();
+    const size_t  count  = src.count();
+    switch (type)
+    {
+    case T::Pos3dHalf:
+        if (layout.hasElement(T::Pos3d))
+        {
+            convert::packHalf(dst, viewOf(src, T::Pos3d), count, 3, 4);
+            return true;
+        }
+        return false;
+
+    case T::TexCoordsHalf:
+        if (layout.hasElement(T::TexCoords))
+        {
+            convert::packHalf(dst, viewOf(src, T::TexCoords), count, 2, 2);
+            return true;
+        }
+        return false;
+
+    case T::NormalOct:
+        if (layout.hasElement(T::Normal))
+        {
+            convert::encodeOctahedral(dst, viewOf(src, T::Normal), count);
+            return true;
+        }
+        return false;
+
+    case T::TangentPacked:
+        if (layout.hasElement(T::Tangent))
+        {
+            const bool        hasFrame   = layout.hasElement(T::Normal) && layout.hasElement(T::Bitangent);
+            ConstStridedBytes normals    = hasFrame ? viewOf(src, T::Normal) : ConstStridedBytes{};
+            ConstStridedBytes bitangents = hasFrame ? viewOf(src, T::Bitangent) : ConstStridedBytes{};
+            convert::packTangents(dst, viewOf(src, T::Tangent), normals, bitangents, count);
+            return true;
+        }
+        return false;
+
+    case T::Color4Unorm8:
+        if (layout.hasElement(T::Color4))
+        {
+            convert::packUnorm8(dst, viewOf(src, T::Color4), count, 4);
+            return true;
+        }
+        if (layout.hasElement(T::Color3))
+        {
+            convert::packUnorm8(dst, viewOf(src, T::Color3), count, 3);
+            return true;
+        }
+        return false;
+
+    default: return false;
+    }
+}
+
+}  // namespace
+
+Buffer convertBuffer(const Buffer& src, Layout layout)
+{
+    Buffer        dst(std::move(layout), src.count());
+    const Layout& dstLayout = dst.layout();
+    for (size_t i = 0; i < dstLayout.getElementCount(); ++i)
+    {
+        const Layout::Attribute& attribute = dstLayout.resolve(i);
+        const uint32_t           stream    = attribute.stream();
+        const StridedBytes       out       = { dst.dataPtr(stream) + attribute.offset(), dstLayout.getStride(stream) };
+
+        if (src.layout().hasElement(attribute.type()))
+        {
+            convert::copy(out, viewOf(src, attribute.type()), src.count(), attribute.size());
+        }
+        else if (!convertAttribute(src, attribute.type(), out))
+        {
+            throw std::runtime_error("vertex::convertBuffer: no source for attribute type " +
+                                     std::to_string(static_cast<int>(attribute.type())));
+        }
+    }
+    return dst;
+}
+
+}  // namespace vertex
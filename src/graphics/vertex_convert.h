@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "graphics/vertex.h"
+
+namespace vertex
+{
+
+// One attribute in a stream: `stride` is in bytes, so a view addresses an attribute inside interleaved vertices as
+// well as a tightly packed array.
+struct ConstStridedBytes
+{
+    const std::byte* data   = nullptr;
+    size_t           stride = 0;
+};
+
+struct StridedBytes
+{
+    std::byte* data   = nullptr;
+    size_t     stride = 0;
+};
+
+// Bulk conversions between attribute streams, from the float types to the compressed ones of vertex_packing.h.
+// They run on AVX2 or SSE4.1 when the CPU has them and on scalar code otherwise, every path giving the same bits.
+namespace convert
+{
+
+// Which kernels `packHalf()` and co. run on, picked once from the CPU features.
+enum class Isa
+{
+    Scalar,
+    Sse41,
+    Avx2,
+};
+Isa getIsa() noexcept;
+
+// `components` floats per element to `dstComponents` half floats, the missing ones set to 1.0.
+void packHalf(StridedBytes dst, ConstStridedBytes src, size_t count, uint32_t components, uint32_t dstComponents) noexcept;
+
+// `components` floats in [0, 1] per element to RGBA8, the missing ones set to 1.0.
+void packUnorm8(StridedBytes dst, ConstStridedBytes src, size_t count, uint32_t components) noexcept;
+
+// vec3 normals to OctNormal.
+void encodeOctahedral(StridedBytes dst, ConstStridedBytes normals, size_t count) noexcept;
+
+// vec3 tangents to PackedTangent. The bitangent sign is the one of dot(cross(normal, tangent), bitangent); it is
+// positive when `normals` or `bitangents` has no data.
+void packTangents(StridedBytes      dst,
+                  ConstStridedBytes tangents,
+                  ConstStridedBytes normals,
+                  ConstStridedBytes bitangents,
+                  size_t            count) noexcept;
+
+// Copies `size` bytes per element: interleaved to separate streams and back.
+void copy(StridedBytes dst, ConstStridedBytes src, size_t count, size_t size) noexcept;
+
+}  // namespace convert
+
+// Builds a buffer of `layout` holding the vertices of `src`. Each attribute is copied from the same type in `src`, or
+// converted from its float counterpart: Pos3d, TexCoords, Normal, Tangent (with Normal and Bitangent for the sign) and
+// Color4 or Color3. Throws std::runtime_error when an attribute has no source.
+//
+//     vertex::Layout packed;
+//     packed.append(AttributeType::Pos3dHalf, 0).append(AttributeType::NormalOct, 1).append(AttributeType::TexCoordsHalf, 1);
+//     vertex::Buffer gpuVertices = vertex::convertBuffer(importedVertices, std::move(packed));
+Buffer convertBuffer(const Buffer& src, Layout layout);
+
+}  // namespace vertex
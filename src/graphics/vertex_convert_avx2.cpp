@@ -0,0 +1,85 @@
+// Built with AVX2 enabled: only called when the CPU and the OS support it, see vertex::convert::getIsa().
+#include "graphics/vertex_convert_kernels.h"
+
+#if VERTEX_CONVERT_X86
+#include <immintrin.h>
+#endif
+
+namespace vertex::convert::detail
+{
+
+#if VERTEX_CONVERT_X86
+
+namespace
+{
+
+struct Avx2
+{
+    using F = __m256;
+    using I = __m256i;
+
+    static constexpr size_t k_width = 8;
+
+    static F gather(const std::byte* p, size_t stride) noexcept
+    {
+        const int32_t s       = static_cast<int32_t>(stride);
+        const I       offsets = _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+        return _mm256_i32gather_ps(reinterpret_cast<const float*>(p), offsets, 1);
+    }
+    static F splat(float f) noexcept { return _mm256_set1_ps(f); }
+    static I splatI(uint32_t u) noexcept { return _mm256_set1_epi32(static_cast<int32_t>(u)); }
+
+    static F add(F a, F b) noexcept { return _mm256_add_ps(a, b); }
+    static F sub(F a, F b) noexcept { return _mm256_sub_ps(a, b); }
+    static F mul(F a, F b) noexcept { return _mm256_mul_ps(a, b); }
+    static F div(F a, F b) noexcept { return _mm256_div_ps(a, b); }
+    static F min(F a, F b) noexcept { return _mm256_min_ps(a, b); }
+    static F max(F a, F b) noexcept { return _mm256_max_ps(a, b); }
+    static F abs(F a) noexcept { return _mm256_and_ps(a, _mm256_castsi256_ps(splatI(0x7fffffffu))); }
+    static I toInt(F a) noexcept { return _mm256_cvtps_epi32(a); }
+
+    static I asInt(F a) noexcept { return _mm256_castps_si256(a); }
+    static F asFloat(I a) noexcept { return _mm256_castsi256_ps(a); }
+
+    static I andI(I a, I b) noexcept { return _mm256_and_si256(a, b); }
+    static I orI(I a, I b) noexcept { return _mm256_or_si256(a, b); }
+    static I xorI(I a, I b) noexcept { return _mm256_xor_si256(a, b); }
+    static I addI(I a, I b) noexcept { return _mm256_add_epi32(a, b); }
+    static I subI(I a, I b) noexcept { return _mm256_sub_epi32(a, b); }
+    template <int N>
+    static I shl(I a) noexcept
+    {
+        return _mm256_slli_epi32(a, N);
+    }
+    template <int N>
+    static I srl(I a) noexcept
+    {
+        return _mm256_srli_epi32(a, N);
+    }
+
+    static I less(F a, F b) noexcept { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+    static I greaterI(I a, I b) noexcept { return _mm256_cmpgt_epi32(a, b); }
+    static F select(I mask, F a, F b) noexcept { return _mm256_blendv_ps(b, a, _mm256_castsi256_ps(mask)); }
+    static I selectI(I mask, I a, I b) noexcept { return _mm256_blendv_epi8(b, a, mask); }
+
+    static void store(I a, uint32_t* out) noexcept { _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), a); }
+};
+
+}  // namespace
+
+const Kernels* getAvx2Kernels() noexcept
+{
+    static const Kernels kernels = makeKernels<Avx2>();
+    return &kernels;
+}
+
+#else
+
+const Kernels* getAvx2Kernels() noexcept
+{
+    return nullptr;
+}
+
+#endif
+
+}  // namespace vertex::convert::detail
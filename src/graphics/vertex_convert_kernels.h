@@ -0,0 +1,314 @@
+#pragma once
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#include "graphics/vertex_convert.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define VERTEX_CONVERT_X86 1
+#else
+#define VERTEX_CONVERT_X86 0
+#endif
+
+// Kernels of vertex_convert.h, written once against a lane type: `Scalar` below, `Sse41` and `Avx2` in their own files,
+// which are built with their instruction set enabled. Only those files include this header, and everything in it has
+// internal linkage: the linker must never merge an AVX2 build of a function with the one run by older CPUs.
+//
+// A lane type L holds L::k_width floats (F) or 32-bit integers (I, also used for masks) and provides:
+//     gather(p, stride)                     lane i loads the float at p + i * stride
+//     splat(f), splatI(u)
+//     add, sub, mul, div, min, max, abs     on F, min/max returning b when a is NaN like minps/maxps
+//     toInt(F)                              round to nearest even
+//     asInt(F), asFloat(I)                  bit casts
+//     andI, orI, xorI, addI, subI, shl<N>, srl<N>
+//     less(F, F), greaterI(I, I)            masks, the integer compare being signed
+//     select(mask, a, b), selectI(...)      a where mask is set
+//     store(I, uint32_t* out)               k_width values
+
+namespace vertex::convert::detail
+{
+
+struct Kernels
+{
+    void (*packHalf)(StridedBytes, ConstStridedBytes, size_t, uint32_t, uint32_t) noexcept;
+    void (*packUnorm8)(StridedBytes, ConstStridedBytes, size_t, uint32_t) noexcept;
+    void (*encodeOctahedral)(StridedBytes, ConstStridedBytes, size_t) noexcept;
+    void (*packTangents)(StridedBytes, ConstStridedBytes, ConstStridedBytes, ConstStridedBytes, size_t) noexcept;
+};
+
+const Kernels& getScalarKernels() noexcept;
+const Kernels* getSse41Kernels() noexcept;  // nullptr when not built for x86.
+const Kernels* getAvx2Kernels() noexcept;
+
+namespace
+{
+
+struct Scalar
+{
+    using F = float;
+    using I = uint32_t;
+
+    static constexpr size_t k_width = 1;
+
+    static F gather(const std::byte* p, size_t) noexcept
+    {
+        F f;
+        std::memcpy(&f, p, sizeof(f));
+        return f;
+    }
+    static F splat(float f) noexcept { return f; }
+    static I splatI(uint32_t u) noexcept { return u; }
+
+    static F add(F a, F b) noexcept { return a + b; }
+    static F sub(F a, F b) noexcept { return a - b; }
+    static F mul(F a, F b) noexcept { return a * b; }
+    static F div(F a, F b) noexcept { return a / b; }
+    static F min(F a, F b) noexcept { return a < b ? a : b; }
+    static F max(F a, F b) noexcept { return a > b ? a : b; }
+    static F abs(F a) noexcept { return asFloat(asInt(a) & 0x7fffffffu); }
+    static I toInt(F a) noexcept { return static_cast<I>(::lrintf(a)); }
+
+    static I asInt(F a) noexcept
+    {
+        I i;
+        std::memcpy(&i, &a, sizeof(i));
+        return i;
+    }
+    static F asFloat(I a) noexcept
+    {
+        F f;
+        std::memcpy(&f, &a, sizeof(f));
+        return f;
+    }
+
+    static I andI(I a, I b) noexcept { return a & b; }
+    static I orI(I a, I b) noexcept { return a | b; }
+    static I xorI(I a, I b) noexcept { return a ^ b; }
+    static I addI(I a, I b) noexcept { return a + b; }
+    static I subI(I a, I b) noexcept { return a - b; }
+    template <int N>
+    static I shl(I a) noexcept
+    {
+        return a << N;
+    }
+    template <int N>
+    static I srl(I a) noexcept
+    {
+        return a >> N;
+    }
+
+    static I less(F a, F b) noexcept { return a < b ? ~0u : 0u; }
+    static I greaterI(I a, I b) noexcept { return static_cast<int32_t>(a) > static_cast<int32_t>(b) ? ~0u : 0u; }
+    static F select(I mask, F a, F b) noexcept { return mask ? a : b; }
+    static I selectI(I mask, I a, I b) noexcept { return mask ? a : b; }
+
+    static void store(I a, uint32_t* out) noexcept { *out = a; }
+};
+
+// Full blocks of L, then the tail one element at a time, so every lane type gives the same bits.
+template <typename Kernel, typename L, typename... Args>
+void run(size_t count, const Args&... args) noexcept
+{
+    size_t i = 0;
+    for (; i + L::k_width <= count; i += L::k_width)
+    {
+        Kernel::template block<L>(i, args...);
+    }
+    for (; i < count; ++i)
+    {
+        Kernel::template block<Scalar>(i, args...);
+    }
+}
+
+template <typename L>
+typename L::F gatherAt(ConstStridedBytes src, size_t first, uint32_t component) noexcept
+{
+    return L::gather(src.data + first * src.stride + component * sizeof(float), src.stride);
+}
+
+template <typename L, typename T>
+void scatterAt(StridedBytes dst, size_t first, size_t byteOffset, typename L::I values) noexcept
+{
+    uint32_t lanes[L::k_width];
+    L::store(values, lanes);
+    for (size_t i = 0; i < L::k_width; ++i)
+    {
+        const T value = static_cast<T>(lanes[i]);
+        std::memcpy(dst.data + (first + i) * dst.stride + byteOffset, &value, sizeof(T));
+    }
+}
+
+template <typename L>
+typename L::F clamp(typename L::F v, float lo, float hi) noexcept
+{
+    return L::min(L::max(v, L::splat(lo)), L::splat(hi));
+}
+
+// Round to nearest even, overflow to infinity, NaN to a quiet NaN; denormals are kept. Result in the low 16 bits.
+template <typename L>
+typename L::I floatToHalf(typename L::F f) noexcept
+{
+    using I = typename L::I;
+
+    constexpr uint32_t k_f32_infinity = 255u << 23;
+    constexpr uint32_t k_f16_max      = (127u + 16u) << 23;
+    constexpr uint32_t k_denorm_magic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+    constexpr uint32_t k_rebias       = ((15u - 127u) << 23) + 0xfffu;
+
+    I       bits = L::asInt(f);
+    const I sign = L::andI(bits, L::splatI(0x80000000u));
+    bits         = L::xorI(bits, sign);
+
+    const I overflow = L::greaterI(bits, L::splatI(k_f16_max - 1));
+    const I infOrNan = L::selectI(L::greaterI(bits, L::splatI(k_f32_infinity)), L::splatI(0x7e00u), L::splatI(0x7c00u));
+
+    const I denormal = L::greaterI(L::splatI(113u << 23), bits);
+    const I subnorm  = L::subI(L::asInt(L::add(L::asFloat(bits), L::asFloat(L::splatI(k_denorm_magic)))), L::splatI(k_denorm_magic));
+
+    const I odd  = L::andI(L::template srl<13>(bits), L::splatI(1));
+    const I norm = L::template srl<13>(L::addI(L::addI(bits, L::splatI(k_rebias)), odd));
+
+    const I half = L::selectI(overflow, infOrNan, L::selectI(denormal, subnorm, norm));
+    return L::orI(half, L::template srl<16>(sign));
+}
+
+template <typename L>
+typename L::I toSnorm(typename L::F v, float scale, uint32_t mask) noexcept
+{
+    return L::andI(L::toInt(L::mul(clamp<L>(v, -1.0f, 1.0f), L::splat(scale))), L::splatI(mask));
+}
+
+struct PackHalf
+{
+    template <typename L>
+    static void block(size_t first, StridedBytes dst, ConstStridedBytes src, uint32_t components, uint32_t dstComponents) noexcept
+    {
+        for (uint32_t c = 0; c < dstComponents; ++c)
+        {
+            const typename L::F f = c < components ? gatherAt<L>(src, first, c) : L::splat(1.0f);
+            scatterAt<L, uint16_t>(dst, first, c * sizeof(uint16_t), floatToHalf<L>(f));
+        }
+    }
+};
+
+struct PackUnorm8
+{
+    template <typename L>
+    static void block(size_t first, StridedBytes dst, ConstStridedBytes src, uint32_t components) noexcept
+    {
+        typename L::I bits = channel<L>(src, first, 0, components);
+        bits               = L::orI(bits, L::template shl<8>(channel<L>(src, first, 1, components)));
+        bits               = L::orI(bits, L::template shl<16>(channel<L>(src, first, 2, components)));
+        bits               = L::orI(bits, L::template shl<24>(channel<L>(src, first, 3, components)));
+        scatterAt<L, uint32_t>(dst, first, 0, bits);
+    }
+
+    template <typename L>
+    static typename L::I channel(ConstStridedBytes src, size_t first, uint32_t c, uint32_t components) noexcept
+    {
+        const typename L::F f = c < components ? gatherAt<L>(src, first, c) : L::splat(1.0f);
+        return L::toInt(L::mul(clamp<L>(f, 0.0f, 1.0f), L::splat(255.0f)));
+    }
+};
+
+// Same mapping as OctNormal, R16G16_SNORM.
+struct EncodeOctahedral
+{
+    template <typename L>
+    static void block(size_t first, StridedBytes dst, ConstStridedBytes normals) noexcept
+    {
+        using F = typename L::F;
+
+        const F x = gatherAt<L>(normals, first, 0);
+        const F y = gatherAt<L>(normals, first, 1);
+        const F z = gatherAt<L>(normals, first, 2);
+
+        // FLT_MIN keeps a null vector at (0, 0) instead of dividing by zero.
+        const F l1 = L::max(L::add(L::add(L::abs(x), L::abs(y)), L::abs(z)), L::splat(FLT_MIN));
+        const F px = L::div(x, l1);
+        const F py = L::div(y, l1);
+
+        const typename L::I lower = L::less(z, L::splat(0.0f));
+        const F             ex    = L::select(lower, foldedComponent<L>(px, py), px);
+        const F             ey    = L::select(lower, foldedComponent<L>(py, px), py);
+
+        const typename L::I bits = L::orI(toSnorm<L>(ex, 32767.0f, 0xffffu), L::template shl<16>(toSnorm<L>(ey, 32767.0f, 0xffffu)));
+        scatterAt<L, uint32_t>(dst, first, 0, bits);
+    }
+
+    // (1 - |other|) with the sign of `self`.
+    template <typename L>
+    static typename L::F foldedComponent(typename L::F self, typename L::F other) noexcept
+    {
+        const typename L::F magnitude = L::sub(L::splat(1.0f), L::abs(other));
+        return L::asFloat(L::orI(L::asInt(magnitude), L::andI(L::asInt(self), L::splatI(0x80000000u))));
+    }
+};
+
+// Same layout as PackedTangent, A2B10G10R10_SNORM_PACK32.
+struct PackTangents
+{
+    template <typename L>
+    static void block(size_t            first,
+                      StridedBytes      dst,
+                      ConstStridedBytes tangents,
+                      ConstStridedBytes normals,
+                      ConstStridedBytes bitangents) noexcept
+    {
+        using F = typename L::F;
+        using I = typename L::I;
+
+        const F tx = gatherAt<L>(tangents, first, 0);
+        const F ty = gatherAt<L>(tangents, first, 1);
+        const F tz = gatherAt<L>(tangents, first, 2);
+
+        I w = L::splatI(1);  // +1 in two bits; -1 is 3.
+        if (normals.data != nullptr && bitangents.data != nullptr)
+        {
+            const F nx = gatherAt<L>(normals, first, 0);
+            const F ny = gatherAt<L>(normals, first, 1);
+            const F nz = gatherAt<L>(normals, first, 2);
+            const F bx = gatherAt<L>(bitangents, first, 0);
+            const F by = gatherAt<L>(bitangents, first, 1);
+            const F bz = gatherAt<L>(bitangents, first, 2);
+
+            const F cx = L::sub(L::mul(ny, tz), L::mul(nz, ty));
+            const F cy = L::sub(L::mul(nz, tx), L::mul(nx, tz));
+            const F cz = L::sub(L::mul(nx, ty), L::mul(ny, tx));
+            const F d  = L::add(L::add(L::mul(cx, bx), L::mul(cy, by)), L::mul(cz, bz));
+
+            w = L::selectI(L::less(d, L::splat(0.0f)), L::splatI(3), w);
+        }
+
+        I bits = toSnorm<L>(tx, 511.0f, 0x3ffu);
+        bits   = L::orI(bits, L::template shl<10>(toSnorm<L>(ty, 511.0f, 0x3ffu)));
+        bits   = L::orI(bits, L::template shl<20>(toSnorm<L>(tz, 511.0f, 0x3ffu)));
+        bits   = L::orI(bits, L::template shl<30>(w));
+        scatterAt<L, uint32_t>(dst, first, 0, bits);
+    }
+};
+
+template <typename L>
+Kernels makeKernels() noexcept
+{
+    Kernels kernels;
+    kernels.packHalf = [](StridedBytes dst, ConstStridedBytes src, size_t count, uint32_t components, uint32_t dstComponents) noexcept {
+        run<PackHalf, L>(count, dst, src, components, dstComponents);
+    };
+    kernels.packUnorm8 = [](StridedBytes dst, ConstStridedBytes src, size_t count, uint32_t components) noexcept {
+        run<PackUnorm8, L>(count, dst, src, components);
+    };
+    kernels.encodeOctahedral = [](StridedBytes dst, ConstStridedBytes normals, size_t count) noexcept {
+        run<EncodeOctahedral, L>(count, dst, normals);
+    };
+    kernels.packTangents =
+        [](StridedBytes dst, ConstStridedBytes tangents, ConstStridedBytes normals, ConstStridedBytes bitangents, size_t count) noexcept {
+            run<PackTangents, L>(count, dst, tangents, normals, bitangents);
+        };
+    return kernels;
+}
+
+}  // namespace
+
+}  // namespace vertex::convert::detail
@@ -0,0 +1,86 @@
+// Built with SSE4.1 enabled: only called when the CPU has it, see vertex::convert::getIsa().
+#include "graphics/vertex_convert_kernels.h"
+
+#if VERTEX_CONVERT_X86
+#include <smmintrin.h>
+#endif
+
+namespace vertex::convert::detail
+{
+
+#if VERTEX_CONVERT_X86
+
+namespace
+{
+
+struct Sse41
+{
+    using F = __m128;
+    using I = __m128i;
+
+    static constexpr size_t k_width = 4;
+
+    static F gather(const std::byte* p, size_t stride) noexcept
+    {
+        return _mm_setr_ps(Scalar::gather(p, 0),
+                           Scalar::gather(p + stride, 0),
+                           Scalar::gather(p + 2 * stride, 0),
+                           Scalar::gather(p + 3 * stride, 0));
+    }
+    static F splat(float f) noexcept { return _mm_set1_ps(f); }
+    static I splatI(uint32_t u) noexcept { return _mm_set1_epi32(static_cast<int32_t>(u)); }
+
+    static F add(F a, F b) noexcept { return _mm_add_ps(a, b); }
+    static F sub(F a, F b) noexcept { return _mm_sub_ps(a, b); }
+    static F mul(F a, F b) noexcept { return _mm_mul_ps(a, b); }
+    static F div(F a, F b) noexcept { return _mm_div_ps(a, b); }
+    static F min(F a, F b) noexcept { return _mm_min_ps(a, b); }
+    static F max(F a, F b) noexcept { return _mm_max_ps(a, b); }
+    static F abs(F a) noexcept { return _mm_and_ps(a, _mm_castsi128_ps(splatI(0x7fffffffu))); }
+    static I toInt(F a) noexcept { return _mm_cvtps_epi32(a); }
+
+    static I asInt(F a) noexcept { return _mm_castps_si128(a); }
+    static F asFloat(I a) noexcept { return _mm_castsi128_ps(a); }
+
+    static I andI(I a, I b) noexcept { return _mm_and_si128(a, b); }
+    static I orI(I a, I b) noexcept { return _mm_or_si128(a, b); }
+    static I xorI(I a, I b) noexcept { return _mm_xor_si128(a, b); }
+    static I addI(I a, I b) noexcept { return _mm_add_epi32(a, b); }
+    static I subI(I a, I b) noexcept { return _mm_sub_epi32(a, b); }
+    template <int N>
+    static I shl(I a) noexcept
+    {
+        return _mm_slli_epi32(a, N);
+    }
+    template <int N>
+    static I srl(I a) noexcept
+    {
+        return _mm_srli_epi32(a, N);
+    }
+
+    static I less(F a, F b) noexcept { return _mm_castps_si128(_mm_cmplt_ps(a, b)); }
+    static I greaterI(I a, I b) noexcept { return _mm_cmpgt_epi32(a, b); }
+    static F select(I mask, F a, F b) noexcept { return _mm_blendv_ps(b, a, _mm_castsi128_ps(mask)); }
+    static I selectI(I mask, I a, I b) noexcept { return _mm_blendv_epi8(b, a, mask); }
+
+    static void store(I a, uint32_t* out) noexcept { _mm_storeu_si128(reinterpret_cast<__m128i*>(out), a); }
+};
+
+}  // namespace
+
+const Kernels* getSse41Kernels() noexcept
+{
+    static const Kernels kernels = makeKernels<Sse41>();
+    return &kernels;
+}
+
+#else
+
+const Kernels* getSse41Kernels() noexcept
+{
+    return nullptr;
+}
+
+#endif
+
+}  // namespace vertex::convert::detail
@@ -0,0 +1,146 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEFAULT_ALIGNED_GENTYPES
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+namespace vertex
+{
+
+// Storage types of the compressed attributes. Each one is the exact bit pattern of its VkFormat, built from floats by
+// its constructor and read back by `decode()`; the vertex fetch does the same decoding for free on the GPU.
+//
+//     vb[i].attr<vertex::AttributeType::NormalOct>()     = vertex::OctNormal{ normal };
+//     vb[i].attr<vertex::AttributeType::TangentPacked>() = vertex::PackedTangent{ tangent, bitangentSign };
+
+// Three half floats padded to four: 3-component 16-bit formats are rarely supported for vertex fetch.
+struct Half3
+{
+    Half3() noexcept = default;
+    Half3(const glm::vec3& v) noexcept
+        : bits(glm::packHalf4x16(glm::vec4(v.x, v.y, v.z, 1.0f)))
+    {}
+    Half3(float x, float y, float z) noexcept
+        : Half3(glm::vec3(x, y, z))
+    {}
+
+    glm::vec3 decode() const noexcept
+    {
+        const glm::vec4 v = glm::unpackHalf4x16(bits);
+        return { v.x, v.y, v.z };
+    }
+
+    uint64_t bits = 0;  // VK_FORMAT_R16G16B16A16_SFLOAT
+};
+
+struct Half2
+{
+    Half2() noexcept = default;
+    Half2(const glm::vec2& v) noexcept
+        : bits(glm::packHalf2x16(v))
+    {}
+    Half2(float x, float y) noexcept
+        : Half2(glm::vec2(x, y))
+    {}
+
+    glm::vec2 decode() const noexcept { return glm::unpackHalf2x16(bits); }
+
+    uint32_t bits = 0;  // VK_FORMAT_R16G16_SFLOAT
+};
+
+// Unit vector projected on the octahedron |x| + |y| + |z| = 1, whose lower half is folded over the upper one to fill
+// the [-1, 1] square. The shader gets the two components and rebuilds the vector with `decodeOctahedral()` from
+// shader_header/vertex_packing.h.
+struct OctNormal
+{
+    OctNormal() noexcept = default;
+    OctNormal(const glm::vec3& n) noexcept
+        : bits(glm::packSnorm2x16(encode(n)))
+    {}
+
+    glm::vec3 decode() const noexcept
+    {
+        const glm::vec2 e = glm::unpackSnorm2x16(bits);
+
+        float       x = e.x;
+        float       y = e.y;
+        const float z = 1.0f - std::abs(x) - std::abs(y);
+        if (z < 0.0f)
+        {
+            const float t = -z;
+            x += x >= 0.0f ? -t : t;
+            y += y >= 0.0f ? -t : t;
+        }
+        return glm::normalize(glm::vec3(x, y, z));
+    }
+
+    static glm::vec2 encode(const glm::vec3& n) noexcept
+    {
+        const float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+        if (l1 == 0.0f)
+        {
+            return { 0.0f, 0.0f };
+        }
+
+        float x = n.x / l1;
+        float y = n.y / l1;
+        if (n.z < 0.0f)
+        {
+            const float fx = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            const float fy = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+            x              = fx;
+            y              = fy;
+        }
+        return { x, y };
+    }
+
+    uint32_t bits = 0;  // VK_FORMAT_R16G16_SNORM
+};
+
+// Tangent in 10 bits per component, with the handedness of the bitangent in the 2-bit w: the shader computes
+// `bitangent = cross(normal, tangent.xyz) * tangent.w`, so Bitangent needs no attribute of its own. Vertex fetch from
+// this format is optional in Vulkan: check VK_FORMAT_FEATURE_VERTEX_BUFFER_BIT before using it.
+struct PackedTangent
+{
+    PackedTangent() noexcept = default;
+    PackedTangent(const glm::vec3& t, float bitangentSign) noexcept
+        : bits(glm::packSnorm3x10_1x2(glm::vec4(t.x, t.y, t.z, bitangentSign < 0.0f ? -1.0f : 1.0f)))
+    {}
+
+    glm::vec3 decode() const noexcept
+    {
+        const glm::vec4 v = glm::unpackSnorm3x10_1x2(bits);
+        return { v.x, v.y, v.z };
+    }
+    float bitangentSign() const noexcept { return glm::unpackSnorm3x10_1x2(bits).w < 0.0f ? -1.0f : 1.0f; }
+
+    uint32_t bits = 0;  // VK_FORMAT_A2B10G10R10_SNORM_PACK32
+};
+
+struct Unorm8x4
+{
+    Unorm8x4() noexcept = default;
+    Unorm8x4(const glm::vec4& c) noexcept
+        : bits(glm::packUnorm4x8(c))
+    {}
+    Unorm8x4(float r, float g, float b, float a = 1.0f) noexcept
+        : Unorm8x4(glm::vec4(r, g, b, a))
+    {}
+
+    glm::vec4 decode() const noexcept { return glm::unpackUnorm4x8(bits); }
+
+    uint32_t bits = 0;  // VK_FORMAT_R8G8B8A8_UNORM
+};
+
+// Row `row` of `model`, for AttributeType::InstanceRow0 to InstanceRow2. The fourth row of an affine transform is
+// always (0, 0, 0, 1) and is not stored.
+inline glm::vec4 transformRow(const glm::mat4& model, int row) noexcept
+{
+    return glm::vec4(model[0][row], model[1][row], model[2][row], model[3][row]);
+}
+
+}  // namespace vertex
@@ -0,0 +1,87 @@
+#pragma once
+#include <vulkan/vulkan.h>
+
+namespace vulkan
+{
+
+//--------------------------------------------------------------------------------------------------
+/**
+  # functions in vulkan
+
+  - cmdMemoryBarrier : makes every write of `srcStages` visible to the reads of `dstStages`
+  - cmdBufferBarrier : same, restricted to a range of one buffer
+  - cmdComputeToComputeBarrier  : a dispatch reads what the previous one wrote
+  - cmdComputeToIndirectBarrier : draws or dispatches take their arguments from a compute pass
+  - cmdComputeToGraphicsBarrier : draws read compute results as vertices, indices or shader resources
+
+  A global memory barrier costs the same as a buffer barrier on current drivers, so the pass helpers use one
+  rather than listing every buffer a pass wrote.
+
+  Example of usage :
+  \code{.cpp}
+  vkCmdDispatch(cmd, groupCount, 1, 1);  // writes draw commands
+  vulkan::cmdComputeToIndirectBarrier(cmd);
+  vkCmdDrawIndexedIndirect(cmd, drawBuffer, 0, drawCount, sizeof(VkDrawIndexedIndirectCommand));
+  \endcode
+*/
+
+inline void cmdMemoryBarrier(VkCommandBuffer      cmd,
+                             VkPipelineStageFlags srcStages,
+                             VkAccessFlags        srcAccess,
+                             VkPipelineStageFlags dstStages,
+                             VkAccessFlags        dstAccess)
+{
+    VkMemoryBarrier barrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    barrier.srcAccessMask   = srcAccess;
+    barrier.dstAccessMask   = dstAccess;
+    vkCmdPipelineBarrier(cmd, srcStages, dstStages, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+inline void cmdBufferBarrier(VkCommandBuffer      cmd,
+                             VkBuffer             buffer,
+                             VkPipelineStageFlags srcStages,
+                             VkAccessFlags        srcAccess,
+                             VkPipelineStageFlags dstStages,
+                             VkAccessFlags        dstAccess,
+                             VkDeviceSize         offset = 0,
+                             VkDeviceSize         size   = VK_WHOLE_SIZE)
+{
+    VkBufferMemoryBarrier barrier = { VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+    barrier.srcAccessMask         = srcAccess;
+    barrier.dstAccessMask         = dstAccess;
+    barrier.srcQueueFamilyIndex   = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex   = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer                = buffer;
+    barrier.offset                = offset;
+    barrier.size                  = size;
+    vkCmdPipelineBarrier(cmd, srcStages, dstStages, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+}
+
+inline void cmdComputeToComputeBarrier(VkCommandBuffer cmd)
+{
+    cmdMemoryBarrier(cmd,
+                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                     VK_ACCESS_SHADER_WRITE_BIT,
+                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                     VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+}
+
+inline void cmdComputeToIndirectBarrier(VkCommandBuffer cmd)
+{
+    cmdMemoryBarrier(cmd,
+                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                     VK_ACCESS_SHADER_WRITE_BIT,
+                     VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                     VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+}
+
+inline void cmdComputeToGraphicsBarrier(VkCommandBuffer cmd)
+{
+    cmdMemoryBarrier(cmd,
+                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                     VK_ACCESS_SHADER_WRITE_BIT,
+                     VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                     VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_SHADER_READ_BIT);
+}
+
+}  // namespace vulkan
@@ -0,0 +1,322 @@
+#include "graphics/vulkan_helper/dynamic_state_recorder.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace vulkan
+{
+
+void DynamicStateRecorder::init(VkDevice device, bool withExtendedDynamicState3)
+{
+    if (!withExtendedDynamicState3)
+    {
+        return;
+    }
+
+    m_vkCmdSetPolygonModeEXT = reinterpret_cast<PFN_vkCmdSetPolygonModeEXT>(vkGetDeviceProcAddr(device, "vkCmdSetPolygonModeEXT"));
+    m_vkCmdSetDepthClampEnableEXT =
+        reinterpret_cast<PFN_vkCmdSetDepthClampEnableEXT>(vkGetDeviceProcAddr(device, "vkCmdSetDepthClampEnableEXT"));
+    m_vkCmdSetLogicOpEnableEXT =
+        reinterpret_cast<PFN_vkCmdSetLogicOpEnableEXT>(vkGetDeviceProcAddr(device, "vkCmdSetLogicOpEnableEXT"));
+    m_vkCmdSetColorBlendEnableEXT =
+        reinterpret_cast<PFN_vkCmdSetColorBlendEnableEXT>(vkGetDeviceProcAddr(device, "vkCmdSetColorBlendEnableEXT"));
+    m_vkCmdSetColorBlendEquationEXT =
+        reinterpret_cast<PFN_vkCmdSetColorBlendEquationEXT>(vkGetDeviceProcAddr(device, "vkCmdSetColorBlendEquationEXT"));
+    m_vkCmdSetColorWriteMaskEXT =
+        reinterpret_cast<PFN_vkCmdSetColorWriteMaskEXT>(vkGetDeviceProcAddr(device, "vkCmdSetColorWriteMaskEXT"));
+}
+
+void DynamicStateRecorder::begin(VkCommandBuffer cmd)
+{
+    m_cmd        = cmd;
+    m_knownSlots = 0;
+}
+
+void DynamicStateRecorder::apply(const GraphicsPipelineState& state)
+{
+    assert(m_cmd != VK_NULL_HANDLE);
+
+    // States baked into the bound pipeline replaced whatever was recorded before.
+    uint32_t dynamic_slots = 0;
+    for (VkDynamicState dynamicState : state.getDynamicStates())
+    {
+        dynamic_slots |= getSlotMask(dynamicState);
+    }
+    m_knownSlots &= dynamic_slots;
+
+    const VkPipelineRasterizationStateCreateInfo& raster = state.rasterizationState;
+    const VkPipelineDepthStencilStateCreateInfo&  depth  = state.depthStencilState;
+
+    const std::span<const VkPipelineColorBlendAttachmentState> attachments = state.getBlendAttachmentStates();
+    assert(attachments.size() <= k_max_color_attachments);
+    const uint32_t attachment_count = std::min<uint32_t>(static_cast<uint32_t>(attachments.size()), k_max_color_attachments);
+
+    for (VkDynamicState dynamicState : state.getDynamicStates())
+    {
+        switch (dynamicState)
+        {
+        case VK_DYNAMIC_STATE_CULL_MODE:
+            if (update(k_slot_cull_mode, m_cullMode, raster.cullMode))
+            {
+                vkCmdSetCullMode(m_cmd, m_cullMode);
+            }
+            break;
+        case VK_DYNAMIC_STATE_FRONT_FACE:
+            if (update(k_slot_front_face, m_frontFace, raster.frontFace))
+            {
+                vkCmdSetFrontFace(m_cmd, m_frontFace);
+            }
+            break;
+        case VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY:
+            if (update(k_slot_primitive_topology, m_primitiveTopology, state.inputAssemblyState.topology))
+            {
+                vkCmdSetPrimitiveTopology(m_cmd, m_primitiveTopology);
+            }
+            break;
+        case VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE:
+            if (update(k_slot_primitive_restart_enable, m_primitiveRestartEnable, state.inputAssemblyState.primitiveRestartEnable))
+            {
+                vkCmdSetPrimitiveRestartEnable(m_cmd, m_primitiveRestartEnable);
+            }
+            break;
+        case VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE:
+            if (update(k_slot_depth_test_enable, m_depthTestEnable, depth.depthTestEnable))
+            {
+                vkCmdSetDepthTestEnable(m_cmd, m_depthTestEnable);
+            }
+            break;
+        case VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE:
+            if (update(k_slot_depth_write_enable, m_depthWriteEnable, depth.depthWriteEnable))
+            {
+                vkCmdSetDepthWriteEnable(m_cmd, m_depthWriteEnable);
+            }
+            break;
+        case VK_DYNAMIC_STATE_DEPTH_COMPARE_OP:
+            if (update(k_slot_depth_compare_op, m_depthCompareOp, depth.depthCompareOp))
+            {
+                vkCmdSetDepthCompareOp(m_cmd, m_depthCompareOp);
+            }
+            break;
+        case VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE:
+            if (update(k_slot_depth_bounds_test_enable, m_depthBoundsTestEnable, depth.depthBoundsTestEnable))
+            {
+                vkCmdSetDepthBoundsTestEnable(m_cmd, m_depthBoundsTestEnable);
+            }
+            break;
+        case VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE:
+            if (update(k_slot_stencil_test_enable, m_stencilTestEnable, depth.stencilTestEnable))
+            {
+                vkCmdSetStencilTestEnable(m_cmd, m_stencilTestEnable);
+            }
+            break;
+        case VK_DYNAMIC_STATE_STENCIL_OP:
+            if (update(k_slot_stencil_op_front, m_stencilFront, depth.front))
+            {
+                vkCmdSetStencilOp(m_cmd,
+                                  VK_STENCIL_FACE_FRONT_BIT,
+                                  m_stencilFront.failOp,
+                                  m_stencilFront.passOp,
+                                  m_stencilFront.depthFailOp,
+                                  m_stencilFront.compareOp);
+            }
+            if (update(k_slot_stencil_op_back, m_stencilBack, depth.back))
+            {
+                vkCmdSetStencilOp(m_cmd,
+                                  VK_STENCIL_FACE_BACK_BIT,
+                                  m_stencilBack.failOp,
+                                  m_stencilBack.passOp,
+                                  m_stencilBack.depthFailOp,
+                                  m_stencilBack.compareOp);
+            }
+            break;
+        case VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE:
+            if (update(k_slot_depth_bias_enable, m_depthBiasEnable, raster.depthBiasEnable))
+            {
+                vkCmdSetDepthBiasEnable(m_cmd, m_depthBiasEnable);
+            }
+            break;
+        case VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE:
+            if (update(k_slot_rasterizer_discard_enable, m_rasterizerDiscardEnable, raster.rasterizerDiscardEnable))
+            {
+                vkCmdSetRasterizerDiscardEnable(m_cmd, m_rasterizerDiscardEnable);
+            }
+            break;
+        case VK_DYNAMIC_STATE_POLYGON_MODE_EXT:
+            assert(m_vkCmdSetPolygonModeEXT);
+            if (update(k_slot_polygon_mode, m_polygonMode, raster.polygonMode))
+            {
+                m_vkCmdSetPolygonModeEXT(m_cmd, m_polygonMode);
+            }
+            break;
+        case VK_DYNAMIC_STATE_DEPTH_CLAMP_ENABLE_EXT:
+            assert(m_vkCmdSetDepthClampEnableEXT);
+            if (update(k_slot_depth_clamp_enable, m_depthClampEnable, raster.depthClampEnable))
+            {
+                m_vkCmdSetDepthClampEnableEXT(m_cmd, m_depthClampEnable);
+            }
+            break;
+        case VK_DYNAMIC_STATE_LOGIC_OP_ENABLE_EXT:
+            assert(m_vkCmdSetLogicOpEnableEXT);
+            if (update(k_slot_logic_op_enable, m_logicOpEnable, state.colorBlendState.logicOpEnable))
+            {
+                m_vkCmdSetLogicOpEnableEXT(m_cmd, m_logicOpEnable);
+            }
+            break;
+        case VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT:
+        {
+            assert(m_vkCmdSetColorBlendEnableEXT);
+            AttachmentValues<VkBool32> enables;
+            enables.count = attachment_count;
+            for (uint32_t i = 0; i < attachment_count; ++i)
+            {
+                enables.values[i] = attachments[i].blendEnable;
+            }
+            if (update(k_slot_color_blend_enable, m_colorBlendEnables, enables))
+            {
+                m_vkCmdSetColorBlendEnableEXT(m_cmd, 0, enables.count, enables.values.data());
+            }
+            break;
+        }
+        case VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT:
+        {
+            assert(m_vkCmdSetColorBlendEquationEXT);
+            AttachmentValues<VkColorBlendEquationEXT> equations;
+            equations.count = attachment_count;
+            for (uint32_t i = 0; i < attachment_count; ++i)
+            {
+                const VkPipelineColorBlendAttachmentState& attachment = attachments[i];
+                equations.values[i] = { attachment.srcColorBlendFactor,
+                                        attachment.dstColorBlendFactor,
+                                        attachment.colorBlendOp,
+                                        attachment.srcAlphaBlendFactor,
+                                        attachment.dstAlphaBlendFactor,
+                                        attachment.alphaBlendOp };
+            }
+            if (update(k_slot_color_blend_equation, m_colorBlendEquations, equations))
+            {
+                m_vkCmdSetColorBlendEquationEXT(m_cmd, 0, equations.count, equations.values.data());
+            }
+            break;
+        }
+        case VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT:
+        {
+            assert(m_vkCmdSetColorWriteMaskEXT);
+            AttachmentValues<VkColorComponentFlags> masks;
+            masks.count = attachment_count;
+            for (uint32_t i = 0; i < attachment_count; ++i)
+            {
+                masks.values[i] = attachments[i].colorWriteMask;
+            }
+            if (update(k_slot_color_write_mask, m_colorWriteMasks, masks))
+            {
+                m_vkCmdSetColorWriteMaskEXT(m_cmd, 0, masks.count, masks.values.data());
+            }
+            break;
+        }
+        default:
+            // Viewport and scissor have no value in the state, see setViewport() / setScissor(). Other states are left
+            // to the caller.
+            break;
+        }
+    }
+}
+
+void DynamicStateRecorder::setViewport(const VkViewport& viewport)
+{
+    if (update(k_slot_viewport, m_viewport, viewport))
+    {
+        vkCmdSetViewport(m_cmd, 0, 1, &m_viewport);
+    }
+}
+
+void DynamicStateRecorder::setScissor(const VkRect2D& scissor)
+{
+    if (update(k_slot_scissor, m_scissor, scissor))
+    {
+        vkCmdSetScissor(m_cmd, 0, 1, &m_scissor);
+    }
+}
+
+uint32_t DynamicStateRecorder::getSlotMask(VkDynamicState dynamicState)
+{
+    switch (dynamicState)
+    {
+    case VK_DYNAMIC_STATE_VIEWPORT:
+        return 1u << k_slot_viewport;
+    case VK_DYNAMIC_STATE_SCISSOR:
+        return 1u << k_slot_scissor;
+    case VK_DYNAMIC_STATE_CULL_MODE:
+        return 1u << k_slot_cull_mode;
+    case VK_DYNAMIC_STATE_FRONT_FACE:
+        return 1u << k_slot_front_face;
+    case VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY:
+        return 1u << k_slot_primitive_topology;
+    case VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE:
+        return 1u << k_slot_primitive_restart_enable;
+    case VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE:
+        return 1u << k_slot_depth_test_enable;
+    case VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE:
+        return 1u << k_slot_depth_write_enable;
+    case VK_DYNAMIC_STATE_DEPTH_COMPARE_OP:
+        return 1u << k_slot_depth_compare_op;
+    case VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE:
+        return 1u << k_slot_depth_bounds_test_enable;
+    case VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE:
+        return 1u << k_slot_stencil_test_enable;
+    case VK_DYNAMIC_STATE_STENCIL_OP:
+        return (1u << k_slot_stencil_op_front) | (1u << k_slot_stencil_op_back);
+    case VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE:
+        return 1u << k_slot_depth_bias_enable;
+    case VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE:
+        return 1u << k_slot_rasterizer_discard_enable;
+    case VK_DYNAMIC_STATE_POLYGON_MODE_EXT:
+        return 1u << k_slot_polygon_mode;
+    case VK_DYNAMIC_STATE_DEPTH_CLAMP_ENABLE_EXT:
+        return 1u << k_slot_depth_clamp_enable;
+    case VK_DYNAMIC_STATE_LOGIC_OP_ENABLE_EXT:
+        return 1u << k_slot_logic_op_enable;
+    case VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT:
+        return 1u << k_slot_color_blend_enable;
+    case VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT:
+        return 1u << k_slot_color_blend_equation;
+    case VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT:
+        return 1u << k_slot_color_write_mask;
+    default:
+        return 0;
+    }
+}
+
+template <typename T>
+bool DynamicStateRecorder::update(Slot slot, T& current, const T& value)
+{
+    const uint32_t bit = 1u << slot;
+    if ((m_knownSlots & bit) != 0 && std::memcmp(&current, &value, sizeof(T)) == 0)
+    {
+        ++m_skippedCount;
+        return false;
+    }
+
+    current = value;
+    m_knownSlots |= bit;
+    ++m_recordedCount;
+    return true;
+}
+
+template <typename T>
+bool DynamicStateRecorder::update(Slot slot, AttachmentValues<T>& current, const AttachmentValues<T>& value)
+{
+    const uint32_t bit = 1u << slot;
+    if ((m_knownSlots & bit) != 0 && current.count == value.count &&
+        std::memcmp(current.values.data(), value.values.data(), sizeof(T) * value.count) == 0)
+    {
+        ++m_skippedCount;
+        return false;
+    }
+
+    current = value;
+    m_knownSlots |= bit;
+    ++m_recordedCount;
+    return true;
+}
+
+}  // namespace vulkan
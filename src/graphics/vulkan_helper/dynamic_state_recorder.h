@@ -0,0 +1,150 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include <vulkan/vulkan.h>
+
+#include "graphics/vulkan_helper/pipeline_helper.h"
+
+namespace vulkan
+{
+
+//--------------------------------------------------------------------------------------------------
+/**
+  \class vulkan::DynamicStateRecorder
+
+  vulkan::DynamicStateRecorder records the dynamic states of a GraphicsPipelineState into a command buffer,
+  skipping every `vkCmdSet*` whose value is already set. It goes with
+  `GraphicsPipelineState::addExtendedDynamicStates()`, which removes cull mode, depth test, topology and the
+  like from the pipeline key: draws with different values then share one pipeline, and the recorder only
+  emits the values that actually change between them.
+
+  Binding a pipeline overwrites the states it bakes in, so `apply()` must follow every vkCmdBindPipeline;
+  it forgets the states that are static in the newly bound pipeline.
+
+  Example of usage :
+  \code{.cpp}
+  vulkan::DynamicStateRecorder recorder(device, hasExtendedDynamicState3);
+
+  recorder.begin(cmd);
+  for (const auto& draw : draws)
+  {
+      vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, draw.pipeline);
+      recorder.apply(draw.state);
+      recorder.setViewport(viewport);
+      recorder.setScissor(scissor);
+      ...
+  }
+  \endcode
+*/
+
+class DynamicStateRecorder
+{
+public:
+    DynamicStateRecorder(const DynamicStateRecorder&)            = delete;
+    DynamicStateRecorder& operator=(const DynamicStateRecorder&) = delete;
+
+    DynamicStateRecorder() {}
+    DynamicStateRecorder(VkDevice device, bool withExtendedDynamicState3 = false) { init(device, withExtendedDynamicState3); }
+
+    // Loads the VK_EXT_extended_dynamic_state3 entry points when requested; the extension must be enabled.
+    void init(VkDevice device, bool withExtendedDynamicState3 = false);
+
+    // Starts recording into `cmd`. Nothing is assumed to be set yet.
+    void begin(VkCommandBuffer cmd);
+
+    // Records the dynamic states of `state` that differ from the last recorded values. Call right after binding a
+    // pipeline built from `state`.
+    void apply(const GraphicsPipelineState& state);
+
+    void setViewport(const VkViewport& viewport);
+    void setScissor(const VkRect2D& scissor);
+
+    uint64_t getRecordedCount() const { return m_recordedCount; }
+    uint64_t getSkippedCount() const { return m_skippedCount; }
+
+    // Per-attachment blend states are tracked for this many color attachments at most, the most devices support.
+    static constexpr uint32_t k_max_color_attachments = 8;
+
+private:
+    enum Slot : uint32_t
+    {
+        k_slot_viewport,
+        k_slot_scissor,
+        k_slot_cull_mode,
+        k_slot_front_face,
+        k_slot_primitive_topology,
+        k_slot_primitive_restart_enable,
+        k_slot_depth_test_enable,
+        k_slot_depth_write_enable,
+        k_slot_depth_compare_op,
+        k_slot_depth_bounds_test_enable,
+        k_slot_stencil_test_enable,
+        k_slot_stencil_op_front,
+        k_slot_stencil_op_back,
+        k_slot_depth_bias_enable,
+        k_slot_rasterizer_discard_enable,
+        k_slot_polygon_mode,
+        k_slot_depth_clamp_enable,
+        k_slot_logic_op_enable,
+        k_slot_color_blend_enable,
+        k_slot_color_blend_equation,
+        k_slot_color_write_mask,
+        k_slot_count,
+    };
+    static_assert(k_slot_count <= 32);
+
+    // One value per color attachment, kept in place so that `apply()` never allocates.
+    template <typename T>
+    struct AttachmentValues
+    {
+        std::array<T, k_max_color_attachments> values{};
+        uint32_t                               count = 0;
+    };
+
+    // Slots covered by a dynamic state, 0 for the states the recorder does not track.
+    static uint32_t getSlotMask(VkDynamicState dynamicState);
+
+    // Stores `value` as the current value of `slot`. Returns false if it was already set to that value.
+    template <typename T>
+    bool update(Slot slot, T& current, const T& value);
+    template <typename T>
+    bool update(Slot slot, AttachmentValues<T>& current, const AttachmentValues<T>& value);
+
+    VkCommandBuffer m_cmd           = VK_NULL_HANDLE;
+    uint32_t        m_knownSlots    = 0;  // Bit per Slot: the value below matches the command buffer state.
+    uint64_t        m_recordedCount = 0;
+    uint64_t        m_skippedCount  = 0;
+
+    VkViewport          m_viewport{};
+    VkRect2D            m_scissor{};
+    VkCullModeFlags     m_cullMode{};
+    VkFrontFace         m_frontFace{};
+    VkPrimitiveTopology m_primitiveTopology{};
+    VkBool32            m_primitiveRestartEnable{};
+    VkBool32            m_depthTestEnable{};
+    VkBool32            m_depthWriteEnable{};
+    VkCompareOp         m_depthCompareOp{};
+    VkBool32            m_depthBoundsTestEnable{};
+    VkBool32            m_stencilTestEnable{};
+    VkStencilOpState    m_stencilFront{};
+    VkStencilOpState    m_stencilBack{};
+    VkBool32            m_depthBiasEnable{};
+    VkBool32            m_rasterizerDiscardEnable{};
+    VkPolygonMode       m_polygonMode{};
+    VkBool32            m_depthClampEnable{};
+    VkBool32            m_logicOpEnable{};
+
+    AttachmentValues<VkBool32>                m_colorBlendEnables;
+    AttachmentValues<VkColorBlendEquationEXT> m_colorBlendEquations;
+    AttachmentValues<VkColorComponentFlags>   m_colorWriteMasks;
+
+    PFN_vkCmdSetPolygonModeEXT        m_vkCmdSetPolygonModeEXT        = nullptr;
+    PFN_vkCmdSetDepthClampEnableEXT   m_vkCmdSetDepthClampEnableEXT   = nullptr;
+    PFN_vkCmdSetLogicOpEnableEXT      m_vkCmdSetLogicOpEnableEXT      = nullptr;
+    PFN_vkCmdSetColorBlendEnableEXT   m_vkCmdSetColorBlendEnableEXT   = nullptr;
+    PFN_vkCmdSetColorBlendEquationEXT m_vkCmdSetColorBlendEquationEXT = nullptr;
+    PFN_vkCmdSetColorWriteMaskEXT     m_vkCmdSetColorWriteMaskEXT     = nullptr;
+};
+
+}  // namespace vulkan
@@ -0,0 +1,239 @@
+#include "graphics/vulkan_helper/pipeline_cache_helper.h"
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+#include "utils/hash.h"
+#include "utils/log.h"
+
+namespace vulkan
+{
+
+namespace
+{
+
+constexpr uint32_t k_cache_file_magic   = 0x48435050;  // "PPCH"
+constexpr uint32_t k_cache_file_version = 1;
+
+struct CacheFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t driverVersion;
+    uint32_t reserved;
+    uint8_t  driverUUID[VK_UUID_SIZE];
+    uint64_t dataSize;
+    uint64_t dataHash;
+};
+static_assert(sizeof(CacheFileHeader) == 48);
+
+struct DeviceIdentity
+{
+    VkPhysicalDeviceProperties   props;
+    VkPhysicalDeviceIDProperties ids;
+};
+
+DeviceIdentity queryDeviceIdentity(VkPhysicalDevice gpu)
+{
+    DeviceIdentity identity{};
+    identity.ids.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+
+    VkPhysicalDeviceProperties2 props2 = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2 };
+    props2.pNext                       = &identity.ids;
+    vkGetPhysicalDeviceProperties2(gpu, &props2);
+
+    identity.props = props2.properties;
+    return identity;
+}
+
+bool validateCacheBlob(const std::vector<uint8_t>& file, const DeviceIdentity& identity, const uint8_t*& out_data, size_t& out_size)
+{
+    if (file.size() < sizeof(CacheFileHeader))
+    {
+        return false;
+    }
+
+    CacheFileHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    if (header.magic != k_cache_file_magic || header.version != k_cache_file_version)
+    {
+        return false;
+    }
+    if (header.driverVersion != identity.props.driverVersion || std::memcmp(header.driverUUID, identity.ids.driverUUID, VK_UUID_SIZE) != 0)
+    {
+        return false;
+    }
+    if (header.dataSize != file.size() - sizeof(CacheFileHeader))
+    {
+        return false;
+    }
+
+    const uint8_t* data = file.data() + sizeof(CacheFileHeader);
+    const size_t   size = static_cast<size_t>(header.dataSize);
+    if (hashBytes(data, size) != header.dataHash)
+    {
+        return false;
+    }
+
+    // The blob itself must start with the header Vulkan writes for this exact device.
+    VkPipelineCacheHeaderVersionOne vk_header;
+    if (size < sizeof(vk_header))
+    {
+        return false;
+    }
+    std::memcpy(&vk_header, data, sizeof(vk_header));
+
+    if (vk_header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE || vk_header.headerSize < sizeof(vk_header) ||
+        vk_header.vendorID != identity.props.vendorID || vk_header.deviceID != identity.props.deviceID ||
+        std::memcmp(vk_header.pipelineCacheUUID, identity.props.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+    {
+        return false;
+    }
+
+    out_data = data;
+    out_size = size;
+    return true;
+}
+
+std::vector<uint8_t> readFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::ate | std::ios::binary);
+    if (!file.is_open())
+    {
+        return {};
+    }
+
+    const std::streamoff file_size = file.tellg();
+    if (file_size <= 0)
+    {
+        return {};
+    }
+
+    std::vector<uint8_t> buffer(static_cast<size_t>(file_size));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(buffer.data()), file_size);
+    if (!file)
+    {
+        return {};
+    }
+    return buffer;
+}
+
+}  // namespace
+
+VkPipelineCache loadPipelineCache(VkDevice device, VkPhysicalDevice gpu, const std::filesystem::path& path)
+{
+    const DeviceIdentity identity = queryDeviceIdentity(gpu);
+
+    const uint8_t* initial_data = nullptr;
+    size_t         initial_size = 0;
+
+    std::vector<uint8_t> file = readFile(path);
+    if (!file.empty() && !validateCacheBlob(file, identity, initial_data, initial_size))
+    {
+        LogWarn("Pipeline cache [{}] is stale or corrupted, starting from an empty cache.", path.string());
+    }
+
+    VkPipelineCacheCreateInfo info = { VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+    info.pNext                     = nullptr;
+    info.flags                     = 0;
+    info.initialDataSize           = initial_size;
+    info.pInitialData              = initial_data;
+
+    VkPipelineCache cache  = VK_NULL_HANDLE;
+    VkResult        result = vkCreatePipelineCache(device, &info, nullptr, &cache);
+    if (result != VK_SUCCESS && initial_size != 0)
+    {
+        // The driver may still reject a blob that passed our checks, e.g. after a silent driver update.
+        LogWarn("Driver rejected pipeline cache [{}], starting from an empty cache.", path.string());
+
+        info.initialDataSize = 0;
+        info.pInitialData    = nullptr;
+        result               = vkCreatePipelineCache(device, &info, nullptr, &cache);
+    }
+
+    if (result != VK_SUCCESS)
+    {
+        LogError("Failed to create pipeline cache.");
+        return VK_NULL_HANDLE;
+    }
+
+    if (initial_size != 0)
+    {
+        LogInfo("Loaded pipeline cache [{}] ({} bytes).", path.string(), initial_size);
+    }
+    return cache;
+}
+
+bool savePipelineCache(VkDevice device, VkPhysicalDevice gpu, VkPipelineCache cache, const std::filesystem::path& path)
+{
+    if (cache == VK_NULL_HANDLE)
+    {
+        return false;
+    }
+
+    size_t data_size = 0;
+    if (vkGetPipelineCacheData(device, cache, &data_size, nullptr) != VK_SUCCESS || data_size == 0)
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> data(data_size);
+    if (vkGetPipelineCacheData(device, cache, &data_size, data.data()) != VK_SUCCESS)
+    {
+        return false;
+    }
+    data.resize(data_size);
+
+    const DeviceIdentity identity = queryDeviceIdentity(gpu);
+
+    CacheFileHeader header{};
+    header.magic         = k_cache_file_magic;
+    header.version       = k_cache_file_version;
+    header.driverVersion = identity.props.driverVersion;
+    header.dataSize      = data.size();
+    header.dataHash      = hashBytes(data.data(), data.size());
+    std::memcpy(header.driverUUID, identity.ids.driverUUID, VK_UUID_SIZE);
+
+    std::error_code ec;
+    if (path.has_parent_path())
+    {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+
+    std::filesystem::path temp_path = path;
+    temp_path += ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            LogWarn("Failed to open [{}] for writing the pipeline cache.", temp_path.string());
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        file.flush();
+        if (!file)
+        {
+            LogWarn("Failed to write the pipeline cache to [{}].", temp_path.string());
+            file.close();
+            std::filesystem::remove(temp_path, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec)
+    {
+        LogWarn("Failed to replace pipeline cache [{}]: {}.", path.string(), ec.message());
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+
+    return true;
+}
+
+}  // namespace vulkan
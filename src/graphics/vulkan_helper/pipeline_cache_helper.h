@@ -0,0 +1,37 @@
+#pragma once
+#include <filesystem>
+
+#include <vulkan/vulkan.h>
+
+namespace vulkan
+{
+
+//--------------------------------------------------------------------------------------------------
+/**
+  # functions in vulkan
+
+  - loadPipelineCache : creates a VkPipelineCache seeded with the blob stored at `path`
+  - savePipelineCache : writes the content of a VkPipelineCache to `path`
+
+  The file starts with a small header recording the driver version and driver UUID plus a checksum of the
+  blob, followed by the raw `vkGetPipelineCacheData` payload. The embedded Vulkan header (vendor/device id
+  and pipelineCacheUUID) is validated as well. A missing, stale or corrupted file never fails the load:
+  an empty cache is created instead and the file will be rewritten on the next save.
+
+  Saving goes through a temporary file that is renamed over the destination, so a crash mid-write never
+  leaves a truncated cache behind.
+
+  Example of usage :
+  \code{.cpp}
+  VkPipelineCache cache = vulkan::loadPipelineCache(device, gpu, "shader/pipeline_cache.bin");
+  ...
+  vulkan::savePipelineCache(device, gpu, cache, "shader/pipeline_cache.bin");
+  vkDestroyPipelineCache(device, cache, nullptr);
+  \endcode
+*/
+
+VkPipelineCache loadPipelineCache(VkDevice device, VkPhysicalDevice gpu, const std::filesystem::path& path);
+
+bool savePipelineCache(VkDevice device, VkPhysicalDevice gpu, VkPipelineCache cache, const std::filesystem::path& path);
+
+}  // namespace vulkan
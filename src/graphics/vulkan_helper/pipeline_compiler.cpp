@@ -0,0 +1,349 @@
+#include "graphics/vulkan_helper/pipeline_compiler.h"
+#include <algorithm>
+#include <cassert>
+
+#include "utils/log.h"
+
+namespace vulkan
+{
+
+void PipelineCompiler::init(VkDevice device, PipelineStateCache& cache, uint32_t threadCount)
+{
+    assert(m_device == VK_NULL_HANDLE);
+    m_device = device;
+    m_cache  = &cache;
+    m_quit   = false;
+
+    if (threadCount == 0)
+    {
+        const uint32_t hw_threads = std::thread::hardware_concurrency();
+        threadCount               = std::clamp<uint32_t>(hw_threads > 1 ? hw_threads - 1 : 1, 1, 4);
+    }
+
+    m_workers.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; ++i)
+    {
+        m_workers.emplace_back(&PipelineCompiler::workerLoop, this);
+    }
+}
+
+void PipelineCompiler::deinit()
+{
+    if (m_device == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_quit = true;
+    }
+    m_jobAvailable.notify_all();
+    for (std::thread& worker : m_workers)
+    {
+        worker.join();
+    }
+    m_workers.clear();
+
+    // Jobs that never started still own their shader modules.
+    for (const auto& job : m_jobs)
+    {
+        for (VkShaderModule module : job->modules)
+        {
+            vkDestroyShaderModule(m_device, module, nullptr);
+        }
+    }
+    m_jobs.clear();
+
+    for (const Result& result : m_results)
+    {
+        if (result.pipeline != VK_NULL_HANDLE)
+        {
+            vkDestroyPipeline(m_device, result.pipeline, nullptr);
+        }
+    }
+    m_results.clear();
+
+    m_pending.clear();
+    m_superseded.clear();
+    m_failed.clear();
+    m_snapshots.clear();
+    m_libraries = nullptr;
+    m_cache     = nullptr;
+    m_device    = VK_NULL_HANDLE;
+}
+
+VkPipeline PipelineCompiler::request(GraphicsPipelineGenerator& generator, VkPipeline fallback)
+{
+    const uint64_t key = generator.hash();
+
+    if (VkPipeline pipeline = m_cache->find(key); pipeline != VK_NULL_HANDLE)
+    {
+        return pipeline;
+    }
+    if (auto it = m_pending.find(key); it != m_pending.end())
+    {
+        return it->second.fallback != VK_NULL_HANDLE ? it->second.fallback : fallback;
+    }
+    if (m_failed.contains(key))
+    {
+        return fallback;
+    }
+
+    if (m_libraries)
+    {
+        // Every part is already compiled: a fast link is cheap enough for the render thread.
+        const PipelineLibraryCache::LibrarySet libraries = m_libraries->find(generator);
+        if (libraries.isComplete())
+        {
+            if (VkPipeline pipeline = m_libraries->link(libraries, false); pipeline != VK_NULL_HANDLE)
+            {
+                m_cache->insert(key, pipeline);
+                keepGenerator(key, generator);
+                if (m_optimizeLinks)
+                {
+                    queueJob(std::make_unique<Job>(key, libraries));
+                }
+                return pipeline;
+            }
+        }
+    }
+
+    keepGenerator(key, generator);
+    queueBuild(key, generator);
+    m_pending.emplace(key, Pending{});
+
+    return fallback;
+}
+
+void PipelineCompiler::collect()
+{
+    std::vector<Result> results;
+    {
+        std::lock_guard lock(m_mutex);
+        results.swap(m_results);
+    }
+
+    for (const Result& result : results)
+    {
+        if (result.optimized)
+        {
+            if (result.pipeline == VK_NULL_HANDLE)
+            {
+                LogWarn("Optimized pipeline link failed (key = {:016x}), keeping the fast-linked pipeline.", result.key);
+                continue;
+            }
+            if (m_cache->find(result.key) == VK_NULL_HANDLE)
+            {
+                // Retired by a rebuild while the link was running.
+                vkDestroyPipeline(m_device, result.pipeline, nullptr);
+                continue;
+            }
+            m_cache->replace(result.key, result.pipeline);
+            continue;
+        }
+
+        Pending pending;
+        if (auto it = m_pending.find(result.key); it != m_pending.end())
+        {
+            pending = it->second;
+            m_pending.erase(it);
+        }
+        if (m_superseded.erase(result.key) != 0)
+        {
+            // Its rebuild landed first; nothing was ever handed this pipeline.
+            if (result.pipeline != VK_NULL_HANDLE)
+            {
+                vkDestroyPipeline(m_device, result.pipeline, nullptr);
+            }
+            continue;
+        }
+        if (result.pipeline == VK_NULL_HANDLE)
+        {
+            LogError("Background pipeline compilation failed (key = {:016x}).", result.key);
+            m_failed.insert(result.key);
+            continue;
+        }
+        m_cache->insert(result.key, result.pipeline);
+
+        if (pending.replacing)
+        {
+            retireReplaced(pending.replacedKey);
+        }
+    }
+}
+
+void PipelineCompiler::waitIdle()
+{
+    {
+        std::unique_lock lock(m_mutex);
+        m_jobDone.wait(lock, [this] { return m_jobs.empty() && m_running == 0; });
+    }
+    collect();
+}
+
+uint32_t PipelineCompiler::rebuildShader(uint64_t oldIdentity, VkShaderModule shaderModule, uint64_t identity)
+{
+    std::vector<std::pair<uint64_t, Snapshot>> rebuilds;
+    for (const auto& [key, snapshot] : m_snapshots)
+    {
+        Snapshot rebuild = makeSnapshot(*snapshot.generator);
+        if (rebuild.generator->replaceShader(oldIdentity, shaderModule, identity))
+        {
+            rebuilds.emplace_back(key, std::move(rebuild));
+        }
+    }
+
+    uint32_t count = 0;
+    for (auto& [oldKey, rebuild] : rebuilds)
+    {
+        const uint64_t key = rebuild.generator->hash();
+        if (m_cache->find(key) != VK_NULL_HANDLE || m_pending.contains(key))
+        {
+            continue;
+        }
+
+        // The old pipeline may still be compiling itself: fall back to whatever it falls back to.
+        VkPipeline fallback = m_cache->find(oldKey);
+        if (auto it = m_pending.find(oldKey); it != m_pending.end())
+        {
+            fallback = it->second.fallback;
+        }
+
+        m_failed.erase(key);
+        queueBuild(key, *rebuild.generator);
+        m_pending.emplace(key, Pending{ fallback, oldKey, true });
+        m_snapshots.emplace(key, std::move(rebuild));
+        ++count;
+    }
+    return count;
+}
+
+void PipelineCompiler::retireReplaced(uint64_t key)
+{
+    m_snapshots.erase(key);
+
+    auto it = m_pending.find(key);
+    if (it == m_pending.end())
+    {
+        m_cache->retire(key);
+        return;
+    }
+
+    // Still compiling: drop it when it lands, and retire now what it was going to replace.
+    Pending& pending = it->second;
+    pending.fallback = VK_NULL_HANDLE;
+    m_superseded.insert(key);
+    if (pending.replacing)
+    {
+        pending.replacing = false;
+        retireReplaced(pending.replacedKey);
+    }
+}
+
+PipelineCompiler::Snapshot PipelineCompiler::makeSnapshot(const GraphicsPipelineGenerator& generator)
+{
+    Snapshot snapshot;
+    snapshot.state     = std::make_unique<GraphicsPipelineState>(generator.getPipelineState());
+    snapshot.generator = std::make_unique<GraphicsPipelineGenerator>(generator, *snapshot.state);
+    return snapshot;
+}
+
+void PipelineCompiler::keepGenerator(uint64_t key, const GraphicsPipelineGenerator& generator)
+{
+    if (!m_keepGenerators || generator.hasTemporaryModules() || m_snapshots.contains(key))
+    {
+        return;
+    }
+    m_snapshots.emplace(key, makeSnapshot(generator));
+}
+
+void PipelineCompiler::queueBuild(uint64_t key, GraphicsPipelineGenerator& generator)
+{
+    const JobType type = m_libraries ? JobType::Libraries : JobType::Monolithic;
+
+    auto job       = std::make_unique<Job>(key, type, generator.getPipelineState());
+    job->generator = std::make_unique<GraphicsPipelineGenerator>(generator, job->state);
+    job->modules   = generator.releaseTemporaryModules();
+    queueJob(std::move(job));
+}
+
+void PipelineCompiler::queueJob(std::unique_ptr<Job> job)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_jobAvailable.notify_one();
+}
+
+void PipelineCompiler::workerLoop()
+{
+    for (;;)
+    {
+        std::unique_ptr<Job> job;
+        {
+            std::unique_lock lock(m_mutex);
+            m_jobAvailable.wait(lock, [this] { return m_quit || !m_jobs.empty(); });
+            if (m_quit)
+            {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            ++m_running;
+        }
+
+        VkPipeline           pipeline = VK_NULL_HANDLE;
+        std::unique_ptr<Job> follow_up;
+        switch (job->type)
+        {
+        case JobType::Monolithic:
+            pipeline = job->generator->createPipeline();
+            break;
+
+        case JobType::Libraries:
+        {
+            const PipelineLibraryCache::LibrarySet libraries = m_libraries->getOrCreate(*job->generator);
+            if (libraries.isComplete())
+            {
+                pipeline = m_libraries->link(libraries, false);
+                if (pipeline != VK_NULL_HANDLE && m_optimizeLinks)
+                {
+                    follow_up = std::make_unique<Job>(job->key, libraries);
+                }
+            }
+            break;
+        }
+
+        case JobType::OptimizedLink:
+            pipeline = m_libraries->link(job->libraries, true);
+            break;
+        }
+
+        const bool has_follow_up = follow_up != nullptr;
+
+        job->generator.reset();
+        for (VkShaderModule module : job->modules)
+        {
+            vkDestroyShaderModule(m_device, module, nullptr);
+        }
+
+        {
+            std::lock_guard lock(m_mutex);
+            m_results.push_back({ job->key, pipeline, job->type == JobType::OptimizedLink });
+            if (follow_up)
+            {
+                m_jobs.push_back(std::move(follow_up));
+            }
+            --m_running;
+        }
+        if (has_follow_up)
+        {
+            m_jobAvailable.notify_one();
+        }
+        m_jobDone.notify_all();
+    }
+}
+
+}  // namespace vulkan
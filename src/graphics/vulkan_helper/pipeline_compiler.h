@@ -0,0 +1,184 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "graphics/vulkan_helper/pipeline_helper.h"
+#include "graphics/vulkan_helper/pipeline_library_cache.h"
+#include "graphics/vulkan_helper/pipeline_state_cache.h"
+
+namespace vulkan
+{
+
+//--------------------------------------------------------------------------------------------------
+/**
+  \class vulkan::PipelineCompiler
+
+  vulkan::PipelineCompiler moves `vkCreateGraphicsPipelines` off the render thread. `request()` returns the
+  pipeline straight from the vulkan::PipelineStateCache when it exists. Otherwise it snapshots the generator,
+  queues it on a pool of worker threads, and returns the fallback pipeline (or VK_NULL_HANDLE, meaning "skip
+  this draw") until the pipeline is done. Finished pipelines are handed to the state cache by `collect()`,
+  which the render thread calls once per frame, so the cache itself is only ever touched by one thread.
+
+  Shader modules added from code are taken over by the job and destroyed once the pipeline is built. Entry
+  point names must outlive the request.
+
+  With a vulkan::PipelineLibraryCache attached, jobs compile the missing library parts and fast-link them.
+  When every part is already cached, the fast link happens right away in `request()` and the pipeline is
+  usable in the same frame. Either way an optimized link can be queued afterwards; it replaces the
+  fast-linked pipeline in the state cache when done.
+
+  With `setKeepGenerators(true)` the compiler keeps a copy of every generator it was given, so that
+  `rebuildShader()` can rebuild the pipelines using a shader after it changed. Until the new pipeline is done,
+  requests for it get the old one; once it is collected, the old one is retired. A rebuild of a pipeline that is
+  still compiling is chained to it: whichever lands last, the outdated pipeline never stays in the cache.
+
+  Example of usage :
+  \code{.cpp}
+  vulkan::PipelineCompiler compiler(device, psoCache);
+
+  // every frame
+  compiler.collect();
+  VkPipeline pipeline = compiler.request(pgen, fallbackPipeline);
+  if (pipeline != VK_NULL_HANDLE)
+  {
+      vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+      ...
+  }
+  \endcode
+*/
+
+class PipelineCompiler
+{
+public:
+    PipelineCompiler(const PipelineCompiler&)            = delete;
+    PipelineCompiler& operator=(const PipelineCompiler&) = delete;
+
+    PipelineCompiler() {}
+    PipelineCompiler(VkDevice device, PipelineStateCache& cache, uint32_t threadCount = 0) { init(device, cache, threadCount); }
+    ~PipelineCompiler() { deinit(); }
+
+    // threadCount == 0 picks a count from the hardware concurrency.
+    void init(VkDevice device, PipelineStateCache& cache, uint32_t threadCount = 0);
+    void deinit();
+
+    // Builds pipelines from graphics pipeline libraries instead of monolithically. Pass nullptr to disable.
+    void setLibraryCache(PipelineLibraryCache* libraries, bool optimizeLinks = true)
+    {
+        m_libraries     = libraries;
+        m_optimizeLinks = optimizeLinks;
+    }
+
+    // Keeps a copy of every generator passed to `request()`, for `rebuildShader()`. Generators with shaders added from
+    // code are not kept: their modules are destroyed once the pipeline is built.
+    void setKeepGenerators(bool keep) { m_keepGenerators = keep; }
+
+    // Returns the finished pipeline, or `fallback` while it is still being compiled (or failed to compile).
+    VkPipeline request(GraphicsPipelineGenerator& generator, VkPipeline fallback = VK_NULL_HANDLE);
+
+    // Publishes pipelines finished since the last call into the state cache. Call from the render thread.
+    void collect();
+
+    // Blocks until every queued job is finished, then collects them.
+    void waitIdle();
+
+    // Queues a rebuild of every kept pipeline using the shader identified by `oldIdentity`, with `shaderModule` in its
+    // place. Returns the number of pipelines queued.
+    uint32_t rebuildShader(uint64_t oldIdentity, VkShaderModule shaderModule, uint64_t identity);
+
+    size_t getPendingCount() const { return m_pending.size(); }
+
+private:
+    enum class JobType
+    {
+        Monolithic,     // vkCreateGraphicsPipelines on the full generator
+        Libraries,      // compile the missing library parts, then fast link
+        OptimizedLink,  // link-time optimized link of cached libraries
+    };
+
+    struct Job
+    {
+        Job(uint64_t key_, JobType type_, const GraphicsPipelineState& state_)
+            : key(key_)
+            , type(type_)
+            , state(state_)
+        {}
+        Job(uint64_t key_, const PipelineLibraryCache::LibrarySet& libraries_)
+            : key(key_)
+            , type(JobType::OptimizedLink)
+            , libraries(libraries_)
+        {}
+
+        uint64_t                                   key;
+        JobType                                    type;
+        GraphicsPipelineState                      state;
+        std::unique_ptr<GraphicsPipelineGenerator> generator;
+        std::vector<VkShaderModule>                modules;
+        PipelineLibraryCache::LibrarySet           libraries;
+    };
+
+    struct Result
+    {
+        uint64_t   key       = 0;
+        VkPipeline pipeline  = VK_NULL_HANDLE;
+        bool       optimized = false;
+    };
+
+    struct Pending
+    {
+        VkPipeline fallback    = VK_NULL_HANDLE;  // Returned by `request()` until the pipeline is done.
+        uint64_t   replacedKey = 0;               // Retired once the pipeline is done, if `replacing`.
+        bool       replacing   = false;
+    };
+
+    struct Snapshot
+    {
+        std::unique_ptr<GraphicsPipelineState>     state;
+        std::unique_ptr<GraphicsPipelineGenerator> generator;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(uint64_t key) const noexcept { return static_cast<size_t>(key); }
+    };
+
+    static Snapshot makeSnapshot(const GraphicsPipelineGenerator& generator);
+
+    void keepGenerator(uint64_t key, const GraphicsPipelineGenerator& generator);
+    void retireReplaced(uint64_t key);
+    void queueBuild(uint64_t key, GraphicsPipelineGenerator& generator);
+    void queueJob(std::unique_ptr<Job> job);
+    void workerLoop();
+
+    VkDevice              m_device         = VK_NULL_HANDLE;
+    PipelineStateCache*   m_cache          = nullptr;
+    PipelineLibraryCache* m_libraries      = nullptr;
+    bool                  m_optimizeLinks  = true;
+    bool                  m_keepGenerators = false;
+
+    std::vector<std::thread> m_workers;
+
+    std::mutex                       m_mutex;
+    std::condition_variable          m_jobAvailable;
+    std::condition_variable          m_jobDone;
+    std::deque<std::unique_ptr<Job>> m_jobs;
+    std::vector<Result>              m_results;
+    uint32_t                         m_running = 0;
+    bool                             m_quit    = false;
+
+    // Only touched by the render thread.
+    std::unordered_map<uint64_t, Pending, KeyHash>  m_pending;
+    std::unordered_set<uint64_t, KeyHash>           m_superseded;  // Pending, but their rebuild is already published.
+    std::unordered_set<uint64_t, KeyHash>           m_failed;
+    std::unordered_map<uint64_t, Snapshot, KeyHash> m_snapshots;
+};
+
+}  // namespace vulkan
@@ -1,8 +1,33 @@
 #include "graphics/vulkan_helper/pipeline_helper.h"
+#include <algorithm>
 
 namespace vulkan
 {
 
+namespace
+{
+
+// Topologies of the same class are interchangeable when VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY is set.
+uint32_t getTopologyClass(VkPrimitiveTopology topology)
+{
+    switch (topology)
+    {
+    case VK_PRIMITIVE_TOPOLOGY_POINT_LIST:
+        return 0;
+    case VK_PRIMITIVE_TOPOLOGY_LINE_LIST:
+    case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+    case VK_PRIMITIVE_TOPOLOGY_LINE_LIST_WITH_ADJACENCY:
+    case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP_WITH_ADJACENCY:
+        return 1;
+    case VK_PRIMITIVE_TOPOLOGY_PATCH_LIST:
+        return 3;
+    default:
+        return 2;
+    }
+}
+
+}  // namespace
+
 // Initialize the state to common values: triangle list topology, depth test enabled,
 // dynamic viewport and scissor, one render target, blending disabled
 GraphicsPipelineState::GraphicsPipelineState()
@@ -106,6 +131,245 @@ void GraphicsPipelineState::update()
     }
 }
 
+uint64_t GraphicsPipelineState::hash() const
+{
+    return Hasher(hashVertexInput()).add(hashPreRasterization()).add(hashFragmentShader()).add(hashFragmentOutput()).get();
+}
+
+uint64_t GraphicsPipelineState::hashVertexInput() const
+{
+    Hasher hasher;
+
+    // With a dynamic topology only its class (point, line, triangle or patch) is baked into the pipeline.
+    hasher.add(inputAssemblyState.flags);
+    if (isDynamic(VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY))
+    {
+        hasher.add(getTopologyClass(inputAssemblyState.topology));
+    }
+    else
+    {
+        hasher.add(inputAssemblyState.topology);
+    }
+    if (!isDynamic(VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE))
+    {
+        hasher.add(inputAssemblyState.primitiveRestartEnable);
+    }
+
+    hasher.add(vertexInputState.flags)
+        .add(std::span<const VkVertexInputBindingDescription>(bindingDescriptions))
+        .add(std::span<const VkVertexInputAttributeDescription>(attributeDescriptions));
+
+    hasher.add(std::span<const VkDynamicState>(dynamicStateEnables));
+
+    return hasher.get();
+}
+
+uint64_t GraphicsPipelineState::hashPreRasterization() const
+{
+    Hasher hasher;
+
+    hasher.add(rasterizationState.flags);
+    if (!isDynamic(VK_DYNAMIC_STATE_DEPTH_CLAMP_ENABLE_EXT))
+    {
+        hasher.add(rasterizationState.depthClampEnable);
+    }
+    if (!isDynamic(VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE))
+    {
+        hasher.add(rasterizationState.rasterizerDiscardEnable);
+    }
+    if (!isDynamic(VK_DYNAMIC_STATE_POLYGON_MODE_EXT))
+    {
+        hasher.add(rasterizationState.polygonMode);
+    }
+    if (!isDynamic(VK_DYNAMIC_STATE_CULL_MODE))
+    {
+        hasher.add(rasterizationState.cullMode);
+    }
+    if (!isDynamic(VK_DYNAMIC_STATE_FRONT_FACE))
+    {
+        hasher.add(rasterizationState.frontFace);
+    }
+    if (!isDynamic(VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE))
+    {
+        hasher.add(rasterizationState.depthBiasEnable);
+    }
+    if (!isDynamic(VK_DYNAMIC_STATE_DEPTH_BIAS))
+    {
+        hasher.add(rasterizationState.depthBiasConstantFactor)
+            .add(rasterizationState.depthBiasClamp)
+            .add(rasterizationState.depthBiasSlopeFactor);
+    }
+    if (!isDynamic(VK_DYNAMIC_STATE_LINE_WIDTH))
+    {
+        hasher.add(rasterizationState.lineWidth);
+    }
+
+    hasher.add(viewportState.flags).add(std::span<const VkViewport>(viewports)).add(std::span<const VkRect2D>(scissors));
+
+    hasher.add(std::span<const VkDynamicState>(dynamicStateEnables));
+
+    return hasher.get();
+}
+
+uint64_t GraphicsPipelineState::hashFragmentShader() const
+{
+    Hasher hasher;
+
+    hasher.add(depthStencilState.flags);
+    if (!isDynamic(VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE))
+    {
+        hasher.add(depthStencilState.depthTestEnable);
+    }
+    if (!isDynamic(VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE))
+    {
+        hasher.add(depthStencilState.depthWriteEnable);
+    }
+    if (!isDynamic(VK_DYNAMIC_STATE_DEPTH_COMPARE_OP))
+    {
+        hasher.add(depthStencilState.depthCompareOp);
+    }
+    if (!isDynamic(VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE))
+    {
+        hasher.add(depthStencilState.depthBoundsTestEnable);
+    }
+    if (!isDynamic(VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE))
+    {
+        hasher.add(depthStencilState.stencilTestEnable);
+    }
+    if (!isDynamic(VK_DYNAMIC_STATE_STENCIL_OP))
+    {
+        hasher.add(depthStencilState.front).add(depthStencilState.back);
+    }
+    else
+    {
+        for (const VkStencilOpState& op : { depthStencilState.front, depthStencilState.back })
+        {
+            hasher.add(op.compareMask).add(op.writeMask).add(op.reference);
+        }
+    }
+    hasher.add(depthStencilState.minDepthBounds).add(depthStencilState.maxDepthBounds);
+
+    hashMultisampleState(hasher);
+
+    hasher.add(std::span<const VkDynamicState>(dynamicStateEnables));
+
+    return hasher.get();
+}
+
+uint64_t GraphicsPipelineState::hashFragmentOutput() const
+{
+    Hasher hasher;
+
+    hasher.add(colorBlendState.flags);
+    if (!isDynamic(VK_DYNAMIC_STATE_LOGIC_OP_ENABLE_EXT))
+    {
+        hasher.add(colorBlendState.logicOpEnable);
+    }
+    hasher.add(colorBlendState.logicOp).add(colorBlendState.blendConstants);
+
+    const bool dynamic_enable   = isDynamic(VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT);
+    const bool dynamic_equation = isDynamic(VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT);
+    const bool dynamic_mask     = isDynamic(VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT);
+    if (!dynamic_enable && !dynamic_equation && !dynamic_mask)
+    {
+        hasher.add(std::span<const VkPipelineColorBlendAttachmentState>(blendAttachmentStates));
+    }
+    else
+    {
+        hasher.add(blendAttachmentStates.size());
+        for (const VkPipelineColorBlendAttachmentState& attachment : blendAttachmentStates)
+        {
+            if (!dynamic_enable)
+            {
+                hasher.add(attachment.blendEnable);
+            }
+            if (!dynamic_equation)
+            {
+                hasher.add(attachment.srcColorBlendFactor)
+                    .add(attachment.dstColorBlendFactor)
+                    .add(attachment.colorBlendOp)
+                    .add(attachment.srcAlphaBlendFactor)
+                    .add(attachment.dstAlphaBlendFactor)
+                    .add(attachment.alphaBlendOp);
+            }
+            if (!dynamic_mask)
+            {
+                hasher.add(attachment.colorWriteMask);
+            }
+        }
+    }
+
+    hashMultisampleState(hasher);
+
+    hasher.add(std::span<const VkDynamicState>(dynamicStateEnables));
+
+    return hasher.get();
+}
+
+void GraphicsPipelineState::hashMultisampleState(Hasher& hasher) const
+{
+    hasher.add(multisampleState.flags)
+        .add(multisampleState.rasterizationSamples)
+        .add(multisampleState.sampleShadingEnable)
+        .add(multisampleState.minSampleShading)
+        .add(multisampleState.alphaToCoverageEnable)
+        .add(multisampleState.alphaToOneEnable);
+    if (multisampleState.pSampleMask)
+    {
+        const size_t mask_count = (static_cast<size_t>(multisampleState.rasterizationSamples) + 31) / 32;
+        hasher.add(std::span<const VkSampleMask>(multisampleState.pSampleMask, mask_count));
+    }
+}
+
+void GraphicsPipelineState::addExtendedDynamicStates(bool withExtendedDynamicState3)
+{
+    static constexpr VkDynamicState k_core_states[] = {
+        VK_DYNAMIC_STATE_CULL_MODE,
+        VK_DYNAMIC_STATE_FRONT_FACE,
+        VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY,
+        VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE,
+        VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE,
+        VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE,
+        VK_DYNAMIC_STATE_DEPTH_COMPARE_OP,
+        VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE,
+        VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE,
+        VK_DYNAMIC_STATE_STENCIL_OP,
+        VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE,
+        VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE,
+    };
+    static constexpr VkDynamicState k_eds3_states[] = {
+        VK_DYNAMIC_STATE_POLYGON_MODE_EXT,
+        VK_DYNAMIC_STATE_DEPTH_CLAMP_ENABLE_EXT,
+        VK_DYNAMIC_STATE_LOGIC_OP_ENABLE_EXT,
+        VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT,
+        VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT,
+        VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT,
+    };
+
+    for (VkDynamicState dynamicState : k_core_states)
+    {
+        if (!isDynamic(dynamicState))
+        {
+            addDynamicStateEnable(dynamicState);
+        }
+    }
+    if (withExtendedDynamicState3)
+    {
+        for (VkDynamicState dynamicState : k_eds3_states)
+        {
+            if (!isDynamic(dynamicState))
+            {
+                addDynamicStateEnable(dynamicState);
+            }
+        }
+    }
+}
+
+bool GraphicsPipelineState::isDynamic(VkDynamicState dynamicState) const
+{
+    return std::find(dynamicStateEnables.begin(), dynamicStateEnables.end(), dynamicState) != dynamicStateEnables.end();
+}
+
 VkPipelineColorBlendAttachmentState GraphicsPipelineState::makePipelineColorBlendAttachmentState(VkColorComponentFlags colorWriteMask_,
                                                                                                  VkBool32              blendEnable_,
                                                                                                  VkBlendFactor         srcColorBlendFactor_,
@@ -189,6 +453,24 @@ GraphicsPipelineGenerator::GraphicsPipelineGenerator(VkDevice
     init();
 }
 
+GraphicsPipelineGenerator::GraphicsPipelineGenerator(const GraphicsPipelineGenerator& src, GraphicsPipelineState& pipelineState_)
+    : createInfo(src.createInfo)
+    , device(src.device)
+    , pipelineCache(src.pipelineCache)
+    , shaderStages(src.shaderStages)
+    , shaderIdentities(src.shaderIdentities)
+    , shaderSpecializations(src.shaderSpecializations)
+    , renderTargetColorFormats(src.renderTargetColorFormats)
+    , renderTargetDepthFormat(src.renderTargetDepthFormat)
+    , pipelineState(pipelineState_)
+{
+    if (src.createInfo.pNext == &src.dynamicRenderingInfo)
+    {
+        setPipelineRenderingCreateInfo(src.dynamicRenderingInfo);
+    }
+    init();
+}
+
 void GraphicsPipelineGenerator::setPipelineRenderingCreateInfo(const PipelineRenderingCreateInfo& pipelineRenderingCreateInfo)
 {
     // Deep copy
@@ -225,9 +507,117 @@ VkPipelineShaderStageCreateInfo& GraphicsPipelineGenerator::addShader(VkShaderMo
     shaderStage.pName  = entryPoint;
 
     shaderStages.push_back(shaderStage);
+    shaderIdentities.push_back(Hasher().add(shaderModule).get());
+    shaderSpecializations.emplace_back();
     return shaderStages.back();
 }
 
+VkPipelineShaderStageCreateInfo& GraphicsPipelineGenerator::addShader(VkShaderModule        shaderModule,
+                                                                      uint64_t              identity,
+                                                                      VkShaderStageFlagBits stage,
+                                                                      const char*           entryPoint)
+{
+    VkPipelineShaderStageCreateInfo& shaderStage = addShader(shaderModule, stage, entryPoint);
+    shaderIdentities.back()                      = identity;
+    return shaderStage;
+}
+
+bool GraphicsPipelineGenerator::replaceShader(uint64_t oldIdentity, VkShaderModule shaderModule, uint64_t identity)
+{
+    bool replaced = false;
+    for (size_t i = 0; i < shaderStages.size(); ++i)
+    {
+        if (shaderIdentities[i] == oldIdentity)
+        {
+            shaderStages[i].module = shaderModule;
+            shaderIdentities[i]    = identity;
+            replaced               = true;
+        }
+    }
+    return replaced;
+}
+
+void GraphicsPipelineGenerator::setSpecialization(VkShaderStageFlags stages, const SpecializationConstants& constants)
+{
+    for (size_t i = 0; i < shaderStages.size(); ++i)
+    {
+        if (shaderStages[i].stage & stages)
+        {
+            shaderSpecializations[i] = constants;
+        }
+    }
+}
+
+uint64_t GraphicsPipelineGenerator::hash() const
+{
+    return Hasher(hashLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT))
+        .add(hashLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT))
+        .add(hashLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT))
+        .add(hashLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT))
+        .add(createInfo.flags)
+        .get();
+}
+
+uint64_t GraphicsPipelineGenerator::hashLibrary(VkGraphicsPipelineLibraryFlagBitsEXT part) const
+{
+    switch (part)
+    {
+    case VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT:
+        return pipelineState.hashVertexInput();
+
+    case VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT:
+    case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT:
+    {
+        const bool fragment = part == VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+
+        Hasher hasher(fragment ? pipelineState.hashFragmentShader() : pipelineState.hashPreRasterization());
+        hasher.add(createInfo.layout);
+        for (size_t i = 0; i < shaderStages.size(); ++i)
+        {
+            if ((shaderStages[i].stage == VK_SHADER_STAGE_FRAGMENT_BIT) == fragment)
+            {
+                hasher.add(shaderStages[i].flags).add(shaderStages[i].stage).add(shaderIdentities[i]).add(shaderStages[i].pName);
+                hasher.add(shaderSpecializations[i].hash());
+            }
+        }
+        hashRenderTargets(hasher);
+        return hasher.get();
+    }
+
+    case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT:
+    {
+        Hasher hasher(pipelineState.hashFragmentOutput());
+        hashRenderTargets(hasher);
+        return hasher.get();
+    }
+
+    default:
+        assert(!"Invalid graphics pipeline library part");
+        return 0;
+    }
+}
+
+void GraphicsPipelineGenerator::hashRenderTargets(Hasher& hasher) const
+{
+    hasher.add(createInfo.subpass);
+
+    if (createInfo.pNext == &dynamicRenderingInfo)
+    {
+        hasher.add(dynamicRenderingInfo.viewMask)
+            .add(std::span<const VkFormat>(dynamicRenderingColorFormats))
+            .add(dynamicRenderingInfo.depthAttachmentFormat)
+            .add(dynamicRenderingInfo.stencilAttachmentFormat);
+    }
+    else if (!renderTargetColorFormats.empty() || renderTargetDepthFormat != VK_FORMAT_UNDEFINED)
+    {
+        hasher.add(std::span<const VkFormat>(renderTargetColorFormats)).add(renderTargetDepthFormat);
+    }
+    else
+    {
+        hasher.add(createInfo.renderPass);
+    }
+}
+
 void GraphicsPipelineGenerator::init()
 {
     createInfo.pRasterizationState = &pipelineState.rasterizationState;
@@ -240,4 +630,59 @@ void GraphicsPipelineGenerator::init()
     createInfo.pVertexInputState   = &pipelineState.vertexInputState;
 }
 
+ComputePipelineGenerator::ComputePipelineGenerator(VkDevice device_, VkPipelineLayout layout)
+    : device(device_)
+{
+    createInfo.stage       = { VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO };
+    createInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    createInfo.layout      = layout;
+}
+
+VkPipelineShaderStageCreateInfo& ComputePipelineGenerator::setShader(VkShaderModule shaderModule, uint64_t identity, const char* entryPoint)
+{
+    if (temporaryModule != shaderModule)
+    {
+        destroyShaderModule();
+    }
+    createInfo.stage.module = shaderModule;
+    createInfo.stage.pName  = entryPoint;
+    shaderIdentity          = identity;
+    return createInfo.stage;
+}
+
+VkPipeline ComputePipelineGenerator::createPipeline(VkPipelineCache cache)
+{
+    createInfo.stage.pSpecializationInfo = specialization.empty() ? nullptr : specialization.getInfo();
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (vkCreateComputePipelines(device, cache, 1, &createInfo, nullptr, &pipeline) != VK_SUCCESS)
+    {
+        return VK_NULL_HANDLE;
+    }
+    return pipeline;
+}
+
+uint64_t ComputePipelineGenerator::hash() const
+{
+    // The bind point keeps compute keys apart from graphics keys in a shared PipelineStateCache.
+    return Hasher()
+        .add(VK_PIPELINE_BIND_POINT_COMPUTE)
+        .add(createInfo.flags)
+        .add(createInfo.layout)
+        .add(createInfo.stage.flags)
+        .add(shaderIdentity)
+        .add(createInfo.stage.pName)
+        .add(specialization.hash())
+        .get();
+}
+
+void ComputePipelineGenerator::destroyShaderModule()
+{
+    if (temporaryModule != VK_NULL_HANDLE)
+    {
+        vkDestroyShaderModule(device, temporaryModule, nullptr);
+        temporaryModule = VK_NULL_HANDLE;
+    }
+}
+
 }  // namespace vulkan
@@ -1,8 +1,13 @@
 #pragma once
+#include <span>
 #include <vector>
 
 #include <vulkan/vulkan.hpp>
 
+#include "utils/hash.h"
+
+#include "graphics/vulkan_helper/specialization_constants.h"
+
 namespace vulkan
 {
 
@@ -40,6 +45,17 @@ struct GraphicsPipelineState
     // Attach the pointer values of the structures to the internal arrays
     void update();
 
+    // Stable hash over every value that ends up in the pipeline: rasterization, blend, depth/stencil,
+    // multisample, vertex input, viewport and dynamic states. pNext chains of the state structs are not hashed.
+    uint64_t hash() const;
+
+    // Hashes of the subsets of state consumed by each graphics pipeline library part (VK_EXT_graphics_pipeline_library).
+    // Multisample and dynamic states are shared by several parts and included in each of them.
+    uint64_t hashVertexInput() const;
+    uint64_t hashPreRasterization() const;
+    uint64_t hashFragmentShader() const;
+    uint64_t hashFragmentOutput() const;
+
     static VkPipelineColorBlendAttachmentState makePipelineColorBlendAttachmentState(
         VkColorComponentFlags colorWriteMask_ = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT |
                                                 VK_COLOR_COMPONENT_A_BIT,
@@ -97,6 +113,18 @@ struct GraphicsPipelineState
         return (uint32_t)(dynamicStateEnables.size() - 1);
     }
 
+    // Makes cull mode, front face, topology, primitive restart, depth/stencil test and ops, depth bias enable and
+    // rasterizer discard dynamic (core in Vulkan 1.3). `withExtendedDynamicState3` also makes polygon mode, depth clamp,
+    // logic op enable and the per-attachment blend enable, equation and write mask dynamic (VK_EXT_extended_dynamic_state3).
+    // `hash()` ignores the values of dynamic states, so pipelines that only differ by them collapse into one; the values
+    // are recorded at draw time by vulkan::DynamicStateRecorder.
+    void addExtendedDynamicStates(bool withExtendedDynamicState3 = false);
+
+    bool isDynamic(VkDynamicState dynamicState) const;
+
+    std::span<const VkDynamicState>                      getDynamicStates() const { return dynamicStateEnables; }
+    std::span<const VkPipelineColorBlendAttachmentState> getBlendAttachmentStates() const { return blendAttachmentStates; }
+
 
     void clearBindingDescriptions() { bindingDescriptions.clear(); }
     void setBindingDescriptionsCount(uint32_t bindingDescriptionCount) { bindingDescriptions.resize(bindingDescriptionCount); }
@@ -198,6 +226,7 @@ private:
     std::vector<VkViewport> viewports;
     std::vector<VkRect2D>   scissors;
 
+    void hashMultisampleState(Hasher& hasher) const;
 
     // Helper to set objects for either C and C++
     template <class T, class U>
@@ -244,6 +273,9 @@ public:
                               const VkPipelineLayout&            layout,
                               const PipelineRenderingCreateInfo& pipelineRenderingCreateInfo,
                               GraphicsPipelineState&             pipelineState_);
+    // Copies everything including the shader stages, but builds on another state object. Temporary shader modules
+    // stay owned by `src`; use `releaseTemporaryModules()` to move them elsewhere.
+    GraphicsPipelineGenerator(const GraphicsPipelineGenerator& src, GraphicsPipelineState& pipelineState_);
     const GraphicsPipelineGenerator& operator=(const GraphicsPipelineGenerator& src)
     {
         device        = src.device;
@@ -268,15 +300,36 @@ public:
 
     void setLayout(VkPipelineLayout layout) { createInfo.layout = layout; }
 
+    void setPipelineCache(VkPipelineCache cache) { pipelineCache = cache; }
+
+    // Formats of the render targets used with a VkRenderPass. They replace the render pass handle in `hash()`,
+    // so a pipeline can be shared by every compatible render pass. Not needed with dynamic rendering.
+    void setRenderTargetFormats(std::span<const VkFormat> colorFormats, VkFormat depthFormat = VK_FORMAT_UNDEFINED)
+    {
+        renderTargetColorFormats.assign(colorFormats.begin(), colorFormats.end());
+        renderTargetDepthFormat = depthFormat;
+    }
+
     VkPipelineShaderStageCreateInfo& addShader(const std::string& code, VkShaderStageFlagBits stage, const char* entryPoint = "main");
 
     template <typename T>
     VkPipelineShaderStageCreateInfo& addShader(const std::vector<T>& code, VkShaderStageFlagBits stage, const char* entryPoint = "main");
     VkPipelineShaderStageCreateInfo& addShader(VkShaderModule shaderModule, VkShaderStageFlagBits stage, const char* entryPoint = "main");
+    // Same, but `hash()` identifies the module by `identity`, e.g. a hash of its SPIR-V, instead of by its handle.
+    VkPipelineShaderStageCreateInfo& addShader(VkShaderModule        shaderModule,
+                                               uint64_t              identity,
+                                               VkShaderStageFlagBits stage,
+                                               const char*           entryPoint = "main");
+
+    // Values of the specialization constants of every stage in `stages`. They are part of `hash()`, and the generator
+    // keeps its own copy: `pSpecializationInfo` of the stages is set by `update()`.
+    void setSpecialization(VkShaderStageFlags stages, const SpecializationConstants& constants);
 
     void clearShaders()
     {
         shaderStages.clear();
+        shaderIdentities.clear();
+        shaderSpecializations.clear();
         destroyShaderModules();
     }
 
@@ -292,13 +345,26 @@ public:
     VkPipeline createPipeline(const VkPipelineCache& cache)
     {
         update();
-        VkPipeline pipeline;
-        vkCreateGraphicsPipelines(device, cache, 1, (VkGraphicsPipelineCreateInfo*)&createInfo, nullptr, &pipeline);
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        if (vkCreateGraphicsPipelines(device, cache, 1, (VkGraphicsPipelineCreateInfo*)&createInfo, nullptr, &pipeline) != VK_SUCCESS)
+        {
+            return VK_NULL_HANDLE;
+        }
         return pipeline;
     }
 
     VkPipeline createPipeline() { return createPipeline(pipelineCache); }
 
+    // Hands the modules created by `addShader(code)` over to the caller, who becomes responsible for destroying them.
+    std::vector<VkShaderModule> releaseTemporaryModules() { return std::move(temporaryModules); }
+    bool                        hasTemporaryModules() const { return !temporaryModules.empty(); }
+
+    // Points every stage identified by `oldIdentity` to `shaderModule`. Returns false if no stage used it.
+    bool replaceShader(uint64_t oldIdentity, VkShaderModule shaderModule, uint64_t identity);
+
+    VkDevice                     getDevice() const { return device; }
+    const GraphicsPipelineState& getPipelineState() const { return pipelineState; }
+
     void destroyShaderModules()
     {
         for (const auto& shaderModule : temporaryModules)
@@ -310,13 +376,28 @@ public:
 
     void update()
     {
+        for (size_t i = 0; i < shaderStages.size(); ++i)
+        {
+            shaderStages[i].pSpecializationInfo = shaderSpecializations[i].empty() ? nullptr : shaderSpecializations[i].getInfo();
+        }
         createInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
         createInfo.pStages    = shaderStages.data();
         pipelineState.update();
     }
 
+    // Key of the pipeline this generator would create: pipeline state, shader identities and specialization constants,
+    // layout and render targets. Shaders added from code are identified by a hash of their content, shaders added as
+    // modules by their handle.
+    uint64_t hash() const;
+
+    // Key of one graphics pipeline library part built from this generator. `hash()` combines the four of them.
+    uint64_t hashLibrary(VkGraphicsPipelineLibraryFlagBitsEXT part) const;
+
+    std::span<const VkPipelineShaderStageCreateInfo> getShaderStages() const { return shaderStages; }
+
 private:
     void init();
+    void hashRenderTargets(Hasher& hasher) const;
 
     // Helper to set objects for either C and C++
     template <class T, class U>
@@ -333,8 +414,12 @@ private:
     VkPipelineCache pipelineCache{};
 
     std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
+    std::vector<uint64_t>                        shaderIdentities;
+    std::vector<SpecializationConstants>         shaderSpecializations;  // One per stage.
     std::vector<VkShaderModule>                  temporaryModules;
     std::vector<VkFormat>                        dynamicRenderingColorFormats;
+    std::vector<VkFormat>                        renderTargetColorFormats;
+    VkFormat                                     renderTargetDepthFormat = VK_FORMAT_UNDEFINED;
     GraphicsPipelineState&                       pipelineState;
     PipelineRenderingCreateInfo                  dynamicRenderingInfo = { VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO };
 };
@@ -352,10 +437,85 @@ inline VkPipelineShaderStageCreateInfo& GraphicsPipelineGenerator::addShader(con
     vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule);
     temporaryModules.push_back(shaderModule);
 
-    return addShader(shaderModule, stage, entryPoint);
+    VkPipelineShaderStageCreateInfo& shaderStage = addShader(shaderModule, stage, entryPoint);
+    shaderIdentities.back()                      = hashBytes(code.data(), sizeof(T) * code.size());
+    return shaderStage;
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+\struct vulkan::ComputePipelineGenerator
+
+The compute counterpart of GraphicsPipelineGenerator: a pipeline layout, one compute shader and its specialization
+constants. `hash()` keys it in the same vulkan::PipelineStateCache as the graphics pipelines, and
+`setPipelineCache()` shares the VkPipelineCache persisted between runs.
+
+Example of usage :
+\code{.cpp}
+vulkan::ComputePipelineGenerator pipelineGenerator(m_device, m_pipelineLayout);
+pipelineGenerator.setPipelineCache(m_pipelineCache);
+pipelineGenerator.setShader(shader.module, shader.hash);
+
+VkPipeline pipeline = psoCache.getOrCreate(pipelineGenerator);
+\endcode
+*/
+
+struct ComputePipelineGenerator
+{
+public:
+    ComputePipelineGenerator(VkDevice device_, VkPipelineLayout layout);
+    ComputePipelineGenerator(const ComputePipelineGenerator&)            = delete;
+    ComputePipelineGenerator& operator=(const ComputePipelineGenerator&) = delete;
+    ~ComputePipelineGenerator() { destroyShaderModule(); }
+
+    void setLayout(VkPipelineLayout layout) { createInfo.layout = layout; }
+    void setPipelineCache(VkPipelineCache cache) { pipelineCache = cache; }
+
+    template <typename T>
+    VkPipelineShaderStageCreateInfo& setShader(const std::vector<T>& code, const char* entryPoint = "main");
+    // `identity` stands for the module in `hash()`, e.g. a hash of its SPIR-V.
+    VkPipelineShaderStageCreateInfo& setShader(VkShaderModule shaderModule, uint64_t identity, const char* entryPoint = "main");
+
+    // Part of `hash()`; the generator keeps its own copy.
+    void setSpecialization(const SpecializationConstants& constants) { specialization = constants; }
+
+    VkPipeline createPipeline(VkPipelineCache cache);
+    VkPipeline createPipeline() { return createPipeline(pipelineCache); }
+
+    // Key of the pipeline this generator would create: shader identity, entry point, specialization constants and layout.
+    uint64_t hash() const;
+
+    VkDevice getDevice() const { return device; }
+
+private:
+    void destroyShaderModule();
+
+public:
+    VkComputePipelineCreateInfo createInfo = { VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+
+private:
+    VkDevice                device;
+    VkPipelineCache         pipelineCache{};
+    uint64_t                shaderIdentity = 0;
+    SpecializationConstants specialization;
+    VkShaderModule          temporaryModule = VK_NULL_HANDLE;
+};
+
+template <typename T>
+inline VkPipelineShaderStageCreateInfo& ComputePipelineGenerator::setShader(const std::vector<T>& code, const char* entryPoint)
+{
+    VkShaderModuleCreateInfo moduleInfo{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+    moduleInfo.codeSize = sizeof(T) * code.size();
+    moduleInfo.pCode    = reinterpret_cast<const uint32_t*>(code.data());
+    VkShaderModule shaderModule;
+    vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule);
+
+    destroyShaderModule();
+    temporaryModule = shaderModule;
+    return setShader(shaderModule, hashBytes(code.data(), sizeof(T) * code.size()), entryPoint);
+}
+
 //  class nvvk::GraphicsPipelineGeneratorCombined
 //
 //  In some cases the application may have each state associated to a single pipeline. For convenience,
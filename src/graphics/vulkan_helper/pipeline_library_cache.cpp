@@ -0,0 +1,196 @@
+#include "graphics/vulkan_helper/pipeline_library_cache.h"
+#include <cassert>
+#include <vector>
+
+namespace vulkan
+{
+
+namespace
+{
+
+constexpr VkGraphicsPipelineLibraryFlagBitsEXT k_library_parts[PipelineLibraryCache::k_part_count] = {
+    VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT,
+};
+
+}  // namespace
+
+void PipelineLibraryCache::init(VkDevice device, VkPipelineCache pipelineCache)
+{
+    assert(m_device == VK_NULL_HANDLE);
+    m_device        = device;
+    m_pipelineCache = pipelineCache;
+}
+
+void PipelineLibraryCache::deinit()
+{
+    for (const auto& [key, library] : m_libraries)
+    {
+        vkDestroyPipeline(m_device, library, nullptr);
+    }
+    m_libraries.clear();
+
+    m_pipelineCache = VK_NULL_HANDLE;
+    m_device        = VK_NULL_HANDLE;
+}
+
+PipelineLibraryCache::LibrarySet PipelineLibraryCache::find(const GraphicsPipelineGenerator& generator) const
+{
+    LibrarySet set;
+    set.layout = generator.createInfo.layout;
+
+    std::lock_guard lock(m_mutex);
+    for (uint32_t i = 0; i < k_part_count; ++i)
+    {
+        if (auto it = m_libraries.find(generator.hashLibrary(k_library_parts[i])); it != m_libraries.end())
+        {
+            set.libraries[i] = it->second;
+        }
+    }
+    return set;
+}
+
+PipelineLibraryCache::LibrarySet PipelineLibraryCache::getOrCreate(GraphicsPipelineGenerator& generator)
+{
+    LibrarySet set = find(generator);
+    if (set.isComplete())
+    {
+        return set;
+    }
+
+    generator.update();
+    for (uint32_t i = 0; i < k_part_count; ++i)
+    {
+        if (set.libraries[i] != VK_NULL_HANDLE)
+        {
+            continue;
+        }
+
+        VkPipeline library = createLibrary(generator, k_library_parts[i]);
+        if (library == VK_NULL_HANDLE)
+        {
+            continue;
+        }
+
+        // Another thread may have built the same part in the meantime, keep the first one.
+        std::lock_guard lock(m_mutex);
+        auto [it, inserted] = m_libraries.emplace(generator.hashLibrary(k_library_parts[i]), library);
+        if (!inserted)
+        {
+            vkDestroyPipeline(m_device, library, nullptr);
+        }
+        set.libraries[i] = it->second;
+    }
+    return set;
+}
+
+VkPipeline PipelineLibraryCache::link(const LibrarySet& set, bool optimize) const
+{
+    assert(set.isComplete());
+
+    VkPipelineLibraryCreateInfoKHR library_info = { VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR };
+    library_info.pNext                          = nullptr;
+    library_info.libraryCount                   = k_part_count;
+    library_info.pLibraries                     = set.libraries.data();
+
+    VkGraphicsPipelineCreateInfo info = { VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO };
+    info.pNext                        = &library_info;
+    info.flags                        = optimize ? VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT : 0;
+    info.layout                       = set.layout;
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (vkCreateGraphicsPipelines(m_device, m_pipelineCache, 1, &info, nullptr, &pipeline) != VK_SUCCESS)
+    {
+        return VK_NULL_HANDLE;
+    }
+    return pipeline;
+}
+
+size_t PipelineLibraryCache::size() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_libraries.size();
+}
+
+VkPipeline PipelineLibraryCache::createLibrary(GraphicsPipelineGenerator& generator, VkGraphicsPipelineLibraryFlagBitsEXT part) const
+{
+    const VkGraphicsPipelineCreateInfo& src = generator.createInfo;
+
+    // Chained in front of the generator's own extension structs, e.g. VkPipelineRenderingCreateInfo.
+    VkGraphicsPipelineLibraryCreateInfoEXT library_info = { VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT };
+    library_info.pNext                                  = src.pNext;
+    library_info.flags                                  = part;
+
+    const VkPipelineCreateFlags library_flags =
+        VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+
+    VkGraphicsPipelineCreateInfo info = { VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO };
+    info.pNext                        = &library_info;
+    info.flags                        = src.flags | library_flags;
+    info.pDynamicState                = src.pDynamicState;
+
+    std::vector<VkPipelineShaderStageCreateInfo> stages;
+    switch (part)
+    {
+    case VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT:
+        info.pVertexInputState   = src.pVertexInputState;
+        info.pInputAssemblyState = src.pInputAssemblyState;
+        break;
+
+    case VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT:
+        for (const VkPipelineShaderStageCreateInfo& stage : generator.getShaderStages())
+        {
+            if (stage.stage != VK_SHADER_STAGE_FRAGMENT_BIT)
+            {
+                stages.push_back(stage);
+            }
+        }
+        info.pViewportState      = src.pViewportState;
+        info.pRasterizationState = src.pRasterizationState;
+        info.pTessellationState  = src.pTessellationState;
+        info.layout              = src.layout;
+        info.renderPass          = src.renderPass;
+        info.subpass             = src.subpass;
+        break;
+
+    case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT:
+        for (const VkPipelineShaderStageCreateInfo& stage : generator.getShaderStages())
+        {
+            if (stage.stage == VK_SHADER_STAGE_FRAGMENT_BIT)
+            {
+                stages.push_back(stage);
+            }
+        }
+        info.pMultisampleState  = src.pMultisampleState;
+        info.pDepthStencilState = src.pDepthStencilState;
+        info.layout             = src.layout;
+        info.renderPass         = src.renderPass;
+        info.subpass            = src.subpass;
+        break;
+
+    case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT:
+        info.pColorBlendState  = src.pColorBlendState;
+        info.pMultisampleState = src.pMultisampleState;
+        info.renderPass        = src.renderPass;
+        info.subpass           = src.subpass;
+        break;
+
+    default:
+        assert(!"Invalid graphics pipeline library part");
+        return VK_NULL_HANDLE;
+    }
+
+    info.stageCount = static_cast<uint32_t>(stages.size());
+    info.pStages    = stages.empty() ? nullptr : stages.data();
+
+    VkPipeline library = VK_NULL_HANDLE;
+    if (vkCreateGraphicsPipelines(m_device, m_pipelineCache, 1, &info, nullptr, &library) != VK_SUCCESS)
+    {
+        return VK_NULL_HANDLE;
+    }
+    return library;
+}
+
+}  // namespace vulkan
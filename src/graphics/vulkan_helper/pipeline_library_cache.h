@@ -0,0 +1,98 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+#include "graphics/vulkan_helper/pipeline_helper.h"
+
+namespace vulkan
+{
+
+//--------------------------------------------------------------------------------------------------
+/**
+  \class vulkan::PipelineLibraryCache
+
+  vulkan::PipelineLibraryCache splits graphics pipelines into the four VK_EXT_graphics_pipeline_library parts:
+  vertex input interface, pre-rasterization shaders, fragment shader and fragment output interface. Each part
+  is keyed by `GraphicsPipelineGenerator::hashLibrary()` and compiled once, so pipelines that only differ by
+  their vertex layout or render targets reuse the parts they have in common. A full pipeline is then a link
+  of four cached libraries: a fast link without optimization, or an optimized link that can run in the
+  background and replace the fast one later.
+
+  Libraries are created with RETAIN_LINK_TIME_OPTIMIZATION_INFO, so both kinds of link are always possible.
+  `getOrCreate()` and `link()` may be called from several threads. Linked pipelines are owned by the caller.
+
+  Example of usage :
+  \code{.cpp}
+  vulkan::PipelineLibraryCache libraries(device, pipelineCache);
+
+  vulkan::PipelineLibraryCache::LibrarySet set = libraries.getOrCreate(pgen);
+  VkPipeline fastPipeline      = libraries.link(set, false);
+  VkPipeline optimizedPipeline = libraries.link(set, true);  // typically on a worker thread
+  \endcode
+*/
+
+class PipelineLibraryCache
+{
+public:
+    static constexpr uint32_t k_part_count = 4;
+
+    struct LibrarySet
+    {
+        std::array<VkPipeline, k_part_count> libraries{};
+        VkPipelineLayout                     layout = VK_NULL_HANDLE;
+
+        bool isComplete() const
+        {
+            for (VkPipeline library : libraries)
+            {
+                if (library == VK_NULL_HANDLE)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+public:
+    PipelineLibraryCache(const PipelineLibraryCache&)            = delete;
+    PipelineLibraryCache& operator=(const PipelineLibraryCache&) = delete;
+
+    PipelineLibraryCache() {}
+    PipelineLibraryCache(VkDevice device, VkPipelineCache pipelineCache = VK_NULL_HANDLE) { init(device, pipelineCache); }
+    ~PipelineLibraryCache() { deinit(); }
+
+    void init(VkDevice device, VkPipelineCache pipelineCache = VK_NULL_HANDLE);
+    void deinit();
+
+    // Looks up the libraries matching the generator without compiling anything. Missing parts are VK_NULL_HANDLE.
+    LibrarySet find(const GraphicsPipelineGenerator& generator) const;
+
+    // Compiles the missing parts. The returned set is incomplete only if a compilation failed.
+    LibrarySet getOrCreate(GraphicsPipelineGenerator& generator);
+
+    // Links a complete set into an executable pipeline. Returns VK_NULL_HANDLE on failure.
+    VkPipeline link(const LibrarySet& set, bool optimize) const;
+
+    size_t size() const;
+
+private:
+    struct KeyHash
+    {
+        size_t operator()(uint64_t key) const noexcept { return static_cast<size_t>(key); }
+    };
+
+    VkPipeline createLibrary(GraphicsPipelineGenerator& generator, VkGraphicsPipelineLibraryFlagBitsEXT part) const;
+
+    VkDevice        m_device        = VK_NULL_HANDLE;
+    VkPipelineCache m_pipelineCache = VK_NULL_HANDLE;
+
+    mutable std::mutex                                m_mutex;
+    std::unordered_map<uint64_t, VkPipeline, KeyHash> m_libraries;
+};
+
+}  // namespace vulkan
@@ -0,0 +1,118 @@
+#include "graphics/vulkan_helper/pipeline_state_cache.h"
+#include <cassert>
+
+namespace vulkan
+{
+
+void PipelineStateCache::init(VkDevice device, uint32_t retireFrameCount)
+{
+    assert(m_device == VK_NULL_HANDLE);
+    m_device           = device;
+    m_retireFrameCount = retireFrameCount;
+}
+
+void PipelineStateCache::deinit()
+{
+    for (const auto& [key, pipeline] : m_pipelines)
+    {
+        vkDestroyPipeline(m_device, pipeline, nullptr);
+    }
+    m_pipelines.clear();
+
+    for (const RetiredPipeline& retired : m_retired)
+    {
+        vkDestroyPipeline(m_device, retired.pipeline, nullptr);
+    }
+    m_retired.clear();
+
+    m_frameIndex = 0;
+    m_hitCount   = 0;
+    m_missCount  = 0;
+    m_device     = VK_NULL_HANDLE;
+}
+
+template <typename Generator>
+VkPipeline PipelineStateCache::getOrCreatePipeline(Generator& generator)
+{
+    const uint64_t key = generator.hash();
+
+    if (auto it = m_pipelines.find(key); it != m_pipelines.end())
+    {
+        ++m_hitCount;
+        return it->second;
+    }
+
+    ++m_missCount;
+    VkPipeline pipeline = generator.createPipeline();
+    if (pipeline != VK_NULL_HANDLE)
+    {
+        m_pipelines.emplace(key, pipeline);
+    }
+    return pipeline;
+}
+
+VkPipeline PipelineStateCache::getOrCreate(GraphicsPipelineGenerator& generator)
+{
+    return getOrCreatePipeline(generator);
+}
+
+VkPipeline PipelineStateCache::getOrCreate(ComputePipelineGenerator& generator)
+{
+    return getOrCreatePipeline(generator);
+}
+
+VkPipeline PipelineStateCache::insert(uint64_t key, VkPipeline pipeline)
+{
+    auto [it, inserted] = m_pipelines.emplace(key, pipeline);
+    if (!inserted && it->second != pipeline)
+    {
+        vkDestroyPipeline(m_device, pipeline, nullptr);
+    }
+    return it->second;
+}
+
+void PipelineStateCache::replace(uint64_t key, VkPipeline pipeline)
+{
+    VkPipeline& slot = m_pipelines[key];
+    if (slot != VK_NULL_HANDLE && slot != pipeline)
+    {
+        retirePipeline(slot);
+    }
+    slot = pipeline;
+}
+
+void PipelineStateCache::retire(uint64_t key)
+{
+    if (auto it = m_pipelines.find(key); it != m_pipelines.end())
+    {
+        retirePipeline(it->second);
+        m_pipelines.erase(it);
+    }
+}
+
+void PipelineStateCache::nextFrame()
+{
+    ++m_frameIndex;
+
+    auto it = m_retired.begin();
+    while (it != m_retired.end())
+    {
+        if (it->frame <= m_frameIndex)
+        {
+            vkDestroyPipeline(m_device, it->pipeline, nullptr);
+            it = m_retired.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+VkPipeline PipelineStateCache::find(uint64_t key) const
+{
+    auto it = m_pipelines.find(key);
+    return it != m_pipelines.end() ? it->second : VK_NULL_HANDLE;
+}
+
+}  // namespace vulkan
@@ -0,0 +1,98 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "graphics/vulkan_helper/pipeline_helper.h"
+
+namespace vulkan
+{
+
+//--------------------------------------------------------------------------------------------------
+/**
+  \class vulkan::PipelineStateCache
+
+  vulkan::PipelineStateCache deduplicates pipeline state objects. Pipelines are keyed by
+  `GraphicsPipelineGenerator::hash()`, so two generators describing the same state, shaders, layout and
+  render target formats share one VkPipeline. Compute pipelines live in the same cache, keyed by
+  `ComputePipelineGenerator::hash()`. The cache owns every pipeline it returns; they stay alive
+  until `deinit()`, or until `replace()` swaps them for a better one. Replaced pipelines are destroyed
+  `retireFrameCount` calls to `nextFrame()` later, once no command buffer in flight can reference them.
+
+  Example of usage :
+  \code{.cpp}
+  vulkan::PipelineStateCache psoCache(device);
+
+  vulkan::GraphicsPipelineGenerator pgen(device, pipeLayout, renderPass, pipelineState);
+  pgen.addShader(...);
+  VkPipeline pipeline = psoCache.getOrCreate(pgen);  // second call with an identical generator is a hit
+  \endcode
+*/
+
+class PipelineStateCache
+{
+public:
+    PipelineStateCache(const PipelineStateCache&)            = delete;
+    PipelineStateCache& operator=(const PipelineStateCache&) = delete;
+
+    PipelineStateCache() {}
+    PipelineStateCache(VkDevice device, uint32_t retireFrameCount = 3) { init(device, retireFrameCount); }
+    ~PipelineStateCache() { deinit(); }
+
+    void init(VkDevice device, uint32_t retireFrameCount = 3);
+    void deinit();
+
+    // Returns the pipeline matching the generator, creating it on a miss. Returns VK_NULL_HANDLE if creation failed.
+    VkPipeline getOrCreate(GraphicsPipelineGenerator& generator);
+    VkPipeline getOrCreate(ComputePipelineGenerator& generator);
+
+    VkPipeline find(uint64_t key) const;
+
+    // Takes ownership of a pipeline built elsewhere, e.g. by vulkan::PipelineCompiler. Returns the pipeline stored under
+    // `key`; if the key was already present the incoming pipeline is destroyed.
+    VkPipeline insert(uint64_t key, VkPipeline pipeline);
+
+    // Stores `pipeline` under `key` and retires the pipeline it replaces.
+    void replace(uint64_t key, VkPipeline pipeline);
+
+    // Removes `key` and retires its pipeline, e.g. once a rebuilt pipeline is stored under another key.
+    void retire(uint64_t key);
+
+    // Destroys the retired pipelines that are old enough. Call once per frame.
+    void nextFrame();
+
+    size_t   size() const { return m_pipelines.size(); }
+    uint64_t getHitCount() const { return m_hitCount; }
+    uint64_t getMissCount() const { return m_missCount; }
+
+private:
+    // Keys are already well distributed hashes.
+    struct KeyHash
+    {
+        size_t operator()(uint64_t key) const noexcept { return static_cast<size_t>(key); }
+    };
+
+    template <typename Generator>
+    VkPipeline getOrCreatePipeline(Generator& generator);
+
+    void retirePipeline(VkPipeline pipeline) { m_retired.push_back({ pipeline, m_frameIndex + m_retireFrameCount }); }
+
+    struct RetiredPipeline
+    {
+        VkPipeline pipeline;
+        uint64_t   frame;
+    };
+
+    VkDevice                                          m_device    = VK_NULL_HANDLE;
+    std::unordered_map<uint64_t, VkPipeline, KeyHash> m_pipelines;
+    uint64_t                                          m_hitCount  = 0;
+    uint64_t                                          m_missCount = 0;
+
+    std::vector<RetiredPipeline> m_retired;
+    uint64_t                     m_frameIndex       = 0;
+    uint32_t                     m_retireFrameCount = 3;
+};
+
+}  // namespace vulkan
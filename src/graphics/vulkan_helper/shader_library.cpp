@@ -0,0 +1,216 @@
+#include "graphics/vulkan_helper/shader_library.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+#include "utils/embedded_shaders.h"
+#include "utils/hash.h"
+#include "utils/load_shader.h"
+#include "utils/log.h"
+
+namespace vulkan
+{
+
+void ShaderLibrary::init(VkDevice device, uint32_t retireFrameCount)
+{
+    assert(m_device == VK_NULL_HANDLE);
+    m_device           = device;
+    m_retireFrameCount = retireFrameCount;
+}
+
+void ShaderLibrary::deinit()
+{
+    for (const auto& [hash, module] : m_modules)
+    {
+        vkDestroyShaderModule(m_device, module.module, nullptr);
+    }
+    m_modules.clear();
+    for (const RetiredModule& retired : m_retired)
+    {
+        vkDestroyShaderModule(m_device, retired.module, nullptr);
+    }
+    m_retired.clear();
+    m_shaders.clear();
+
+    m_frameIndex = 0;
+
+    m_device = VK_NULL_HANDLE;
+}
+
+const ShaderLibrary::Shader& ShaderLibrary::get(std::string_view name)
+{
+    if (auto it = m_shaders.find(name); it != m_shaders.end())
+    {
+        return *it->second;
+    }
+
+    auto shader = std::make_unique<Shader>();
+    if (std::span<const uint32_t> embedded = findEmbeddedShader(name); !embedded.empty())
+    {
+        // No file I/O: the path only lets `reload()` pick up a binary rebuilt while the application runs.
+        shader->code = embedded;
+        shader->path = (std::filesystem::path(getShaderSearchPath()) / name).string();
+    }
+    else
+    {
+        std::string path = getFilePathString(std::string(name), { getShaderSearchPath() });
+        if (path.empty())
+        {
+            throw std::runtime_error(std::string("Failed to open file at path = ") + std::string(name));
+        }
+        shader->storage = readCode(path);
+        shader->code    = shader->storage;
+        shader->path    = std::move(path);
+    }
+    shader->hash = hashBytes(shader->code.data(), shader->code.size_bytes());
+
+    const Module& module = getOrCreateModule(shader->hash, shader->code, shader->path);
+    shader->module       = module.module;
+    shader->reflection   = module.reflection;
+
+    return *m_shaders.emplace(std::string(name), std::move(shader)).first->second;
+}
+
+const ShaderLibrary::Shader* ShaderLibrary::find(std::string_view name) const
+{
+    if (auto it = m_shaders.find(name); it != m_shaders.end())
+    {
+        return it->second.get();
+    }
+    return nullptr;
+}
+
+std::vector<ShaderLibrary::Change> ShaderLibrary::reload(const std::filesystem::path& path)
+{
+    const std::filesystem::path normalized = path.lexically_normal();
+
+    std::vector<Shader*> shaders;
+    for (auto& [name, shader] : m_shaders)
+    {
+        if (std::filesystem::path(shader->path).lexically_normal() == normalized)
+        {
+            shaders.push_back(shader.get());
+        }
+    }
+    if (shaders.empty())
+    {
+        return {};
+    }
+
+    std::vector<uint32_t> code;
+    uint64_t              hash   = 0;
+    const Module*         module = nullptr;
+    try
+    {
+        code   = readCode(shaders.front()->path);
+        hash   = hashBytes(code.data(), code.size() * sizeof(uint32_t));
+        module = &getOrCreateModule(hash, code, shaders.front()->path);
+    }
+    catch (const std::exception& e)
+    {
+        LogWarn("Shader reload skipped: {}", e.what());
+        return {};
+    }
+
+    std::vector<Change> changes;
+    for (Shader* shader : shaders)
+    {
+        if (shader->hash == hash)
+        {
+            continue;
+        }
+
+        Change change;
+        change.oldHash = shader->hash;
+        change.hash    = hash;
+
+        shader->storage    = code;
+        shader->code       = shader->storage;
+        shader->hash       = hash;
+        shader->module     = module->module;
+        shader->reflection = module->reflection;
+        change.module      = shader->module;
+        changes.push_back(change);
+    }
+
+    // Modules no shader refers to anymore.
+    for (const Change& change : changes)
+    {
+        auto it = m_modules.find(change.oldHash);
+        if (it == m_modules.end())
+        {
+            continue;
+        }
+        const bool in_use = std::any_of(m_shaders.begin(), m_shaders.end(), [&](const auto& entry) {
+            return entry.second->hash == change.oldHash;
+        });
+        if (!in_use)
+        {
+            m_retired.push_back({ it->second.module, m_frameIndex + m_retireFrameCount });
+            m_modules.erase(it);
+        }
+    }
+    return changes;
+}
+
+void ShaderLibrary::nextFrame()
+{
+    ++m_frameIndex;
+
+    auto it = m_retired.begin();
+    while (it != m_retired.end())
+    {
+        if (it->frame <= m_frameIndex)
+        {
+            vkDestroyShaderModule(m_device, it->module, nullptr);
+            it = m_retired.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+std::vector<uint32_t> ShaderLibrary::readCode(const std::string& path)
+{
+    const std::vector<char> bytes = readShaderFile(path);
+    if (bytes.empty() || bytes.size() % sizeof(uint32_t) != 0)
+    {
+        throw std::runtime_error(std::string("Invalid SPIR-V binary at path = ") + path);
+    }
+
+    std::vector<uint32_t> code(bytes.size() / sizeof(uint32_t));
+    std::memcpy(code.data(), bytes.data(), bytes.size());
+    return code;
+}
+
+const ShaderLibrary::Module& ShaderLibrary::getOrCreateModule(uint64_t hash, std::span<const uint32_t> code, const std::string& path)
+{
+    if (auto it = m_modules.find(hash); it != m_modules.end())
+    {
+        return it->second;
+    }
+
+    Module module;
+    try
+    {
+        module.reflection = reflectShader(code);
+    }
+    catch (const std::exception& e)
+    {
+        throw std::runtime_error(std::string(e.what()) + " in " + path);
+    }
+
+    VkShaderModuleCreateInfo info = { VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+    info.codeSize                 = code.size_bytes();
+    info.pCode                    = code.data();
+    if (vkCreateShaderModule(m_device, &info, nullptr, &module.module) != VK_SUCCESS)
+    {
+        throw std::runtime_error(std::string("Failed to create shader module from ") + path);
+    }
+    return m_modules.emplace(hash, std::move(module)).first->second;
+}
+
+}  // namespace vulkan
@@ -0,0 +1,133 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "graphics/vulkan_helper/shader_reflection.h"
+
+namespace vulkan
+{
+
+//--------------------------------------------------------------------------------------------------
+/**
+  \class vulkan::ShaderLibrary
+
+  vulkan::ShaderLibrary loads each SPIR-V binary once and keeps its VkShaderModule alive until `deinit()`.
+  Shaders are looked up by the name given to `loadShaderCode()`. The first lookup uses the SPIR-V embedded
+  in the executable when there is one, without copying it, and otherwise reads the file from the shader
+  search path; every later one is a single hash map lookup. Binaries with the same content share one module.
+
+  `Shader::hash` is a hash of the SPIR-V; pass it to `GraphicsPipelineGenerator::addShader()` so pipelines
+  are keyed by shader content rather than by module handle. Not thread-safe: use it from the render thread.
+
+  `reload()` re-reads a binary after it changed on disk. The shader gets a new module and hash; the old module
+  is destroyed `retireFrameCount` calls to `nextFrame()` later, as pipelines may still be compiled from it.
+
+  Example of usage :
+  \code{.cpp}
+  vulkan::ShaderLibrary shaders(device);
+
+  const vulkan::ShaderLibrary::Shader& vert = shaders.get("test.vert.spv");
+  pgen.addShader(vert.module, vert.hash, VK_SHADER_STAGE_VERTEX_BIT);
+  \endcode
+*/
+
+class ShaderLibrary
+{
+public:
+    struct Shader
+    {
+        std::string               path;  // Resolved file path; for embedded shaders, where a newer binary would be.
+        std::span<const uint32_t> code;  // Into the executable image for embedded shaders, into `storage` otherwise.
+        std::vector<uint32_t>     storage;
+        uint64_t                  hash   = 0;
+        VkShaderModule            module = VK_NULL_HANDLE;
+        ShaderReflection          reflection;  // Computed once per content hash.
+    };
+
+    struct Change
+    {
+        uint64_t       oldHash = 0;
+        uint64_t       hash    = 0;
+        VkShaderModule module  = VK_NULL_HANDLE;
+    };
+
+public:
+    ShaderLibrary(const ShaderLibrary&)            = delete;
+    ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+
+    ShaderLibrary() {}
+    ShaderLibrary(VkDevice device, uint32_t retireFrameCount = 3) { init(device, retireFrameCount); }
+    ~ShaderLibrary() { deinit(); }
+
+    void init(VkDevice device, uint32_t retireFrameCount = 3);
+    void deinit();
+
+    // Returns the shader, loading it on first use. Throws if the file cannot be read or reflected.
+    const Shader& get(std::string_view name);
+
+    // Returns nullptr if the shader was never loaded.
+    const Shader* find(std::string_view name) const;
+
+    // Re-reads the shaders loaded from `path`. Returns one change per shader whose content differs; a file that cannot be
+    // read, e.g. while it is still being written, is skipped with a warning.
+    std::vector<Change> reload(const std::filesystem::path& path);
+
+    // Destroys the modules replaced by `reload()` that are old enough. Call once per frame, when no pipeline still being
+    // compiled can use them.
+    void nextFrame();
+
+    size_t size() const { return m_shaders.size(); }
+    size_t getModuleCount() const { return m_modules.size(); }
+
+private:
+    // Lets `find()` take a string_view without building a std::string.
+    struct NameHash
+    {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view name) const noexcept { return std::hash<std::string_view>{}(name); }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(uint64_t key) const noexcept { return static_cast<size_t>(key); }
+    };
+
+    struct Module
+    {
+        VkShaderModule   module = VK_NULL_HANDLE;
+        ShaderReflection reflection;
+    };
+
+    struct RetiredModule
+    {
+        VkShaderModule module;
+        uint64_t       frame;
+    };
+
+    // `path` is already resolved, so the search path is not probed again.
+    static std::vector<uint32_t> readCode(const std::string& path);
+
+    // Creates the module and reflection of `code`, unless a binary with the same content was loaded before.
+    const Module& getOrCreateModule(uint64_t hash, std::span<const uint32_t> code, const std::string& path);
+
+    VkDevice m_device = VK_NULL_HANDLE;
+
+    std::unordered_map<std::string, std::unique_ptr<Shader>, NameHash, std::equal_to<>> m_shaders;
+    std::unordered_map<uint64_t, Module, KeyHash>                                       m_modules;  // By content hash.
+
+    std::vector<RetiredModule> m_retired;
+    uint64_t                   m_frameIndex       = 0;
+    uint32_t                   m_retireFrameCount = 3;
+};
+
+}  // namespace vulkan
@@ -0,0 +1,603 @@
+#include "graphics/vulkan_helper/shader_reflection.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace vulkan
+{
+
+namespace
+{
+
+// The subset of the SPIR-V specification needed to find resources and interface variables.
+constexpr uint32_t k_spirv_magic       = 0x07230203;
+constexpr uint32_t k_spirv_header_size = 5;
+
+constexpr uint32_t k_op_entry_point        = 15;
+constexpr uint32_t k_op_type_int           = 21;
+constexpr uint32_t k_op_type_float         = 22;
+constexpr uint32_t k_op_type_vector        = 23;
+constexpr uint32_t k_op_type_matrix        = 24;
+constexpr uint32_t k_op_type_image         = 25;
+constexpr uint32_t k_op_type_sampler       = 26;
+constexpr uint32_t k_op_type_sampled_image = 27;
+constexpr uint32_t k_op_type_array         = 28;
+constexpr uint32_t k_op_type_runtime_array = 29;
+constexpr uint32_t k_op_type_struct        = 30;
+constexpr uint32_t k_op_type_pointer       = 32;
+constexpr uint32_t k_op_constant           = 43;
+constexpr uint32_t k_op_variable           = 59;
+constexpr uint32_t k_op_decorate           = 71;
+constexpr uint32_t k_op_member_decorate    = 72;
+constexpr uint32_t k_op_type_accel_struct  = 5341;
+
+constexpr uint32_t k_decoration_buffer_block  = 3;
+constexpr uint32_t k_decoration_array_stride  = 6;
+constexpr uint32_t k_decoration_matrix_stride = 7;
+constexpr uint32_t k_decoration_built_in      = 11;
+constexpr uint32_t k_decoration_location      = 30;
+constexpr uint32_t k_decoration_binding       = 33;
+constexpr uint32_t k_decoration_set           = 34;
+constexpr uint32_t k_decoration_offset        = 35;
+
+constexpr uint32_t k_storage_uniform_constant = 0;
+constexpr uint32_t k_storage_input            = 1;
+constexpr uint32_t k_storage_uniform          = 2;
+constexpr uint32_t k_storage_push_constant    = 9;
+constexpr uint32_t k_storage_storage_buffer   = 12;
+
+constexpr uint32_t k_dim_buffer       = 5;
+constexpr uint32_t k_dim_subpass_data = 6;
+
+constexpr uint32_t k_invalid = ~0u;
+
+struct Member
+{
+    uint32_t offset       = 0;
+    uint32_t matrixStride = 0;
+};
+
+// Everything known about one result id.
+struct Id
+{
+    uint32_t              opcode = 0;
+    uint32_t              type   = 0;  // Result type of OpVariable and OpConstant.
+    std::vector<uint32_t> operands;    // Words after the result id, and after the result type if any.
+
+    uint32_t set         = 0;
+    uint32_t binding     = k_invalid;
+    uint32_t location    = k_invalid;
+    uint32_t arrayStride = 0;
+    bool     builtIn     = false;
+    bool     bufferBlock = false;
+
+    std::vector<Member> members;
+};
+
+enum class NumericType
+{
+    Unknown,
+    Float,
+    SInt,
+    UInt,
+};
+
+VkShaderStageFlagBits getStage(uint32_t executionModel)
+{
+    switch (executionModel)
+    {
+    case 0: return VK_SHADER_STAGE_VERTEX_BIT;
+    case 1: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+    case 2: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+    case 3: return VK_SHADER_STAGE_GEOMETRY_BIT;
+    case 4: return VK_SHADER_STAGE_FRAGMENT_BIT;
+    case 5: return VK_SHADER_STAGE_COMPUTE_BIT;
+    case 5364: return VK_SHADER_STAGE_TASK_BIT_EXT;
+    case 5365: return VK_SHADER_STAGE_MESH_BIT_EXT;
+    default: throw std::runtime_error("SPIR-V reflection: unsupported execution model " + std::to_string(executionModel));
+    }
+}
+
+NumericType getNumericType(VkFormat format)
+{
+    switch (format)
+    {
+    case VK_FORMAT_R8_UINT:
+    case VK_FORMAT_R8G8_UINT:
+    case VK_FORMAT_R8G8B8_UINT:
+    case VK_FORMAT_R8G8B8A8_UINT:
+    case VK_FORMAT_A2B10G10R10_UINT_PACK32:
+    case VK_FORMAT_R16_UINT:
+    case VK_FORMAT_R16G16_UINT:
+    case VK_FORMAT_R16G16B16_UINT:
+    case VK_FORMAT_R16G16B16A16_UINT:
+    case VK_FORMAT_R32_UINT:
+    case VK_FORMAT_R32G32_UINT:
+    case VK_FORMAT_R32G32B32_UINT:
+    case VK_FORMAT_R32G32B32A32_UINT:
+        return NumericType::UInt;
+
+    case VK_FORMAT_R8_SINT:
+    case VK_FORMAT_R8G8_SINT:
+    case VK_FORMAT_R8G8B8_SINT:
+    case VK_FORMAT_R8G8B8A8_SINT:
+    case VK_FORMAT_A2B10G10R10_SINT_PACK32:
+    case VK_FORMAT_R16_SINT:
+    case VK_FORMAT_R16G16_SINT:
+    case VK_FORMAT_R16G16B16_SINT:
+    case VK_FORMAT_R16G16B16A16_SINT:
+    case VK_FORMAT_R32_SINT:
+    case VK_FORMAT_R32G32_SINT:
+    case VK_FORMAT_R32G32B32_SINT:
+    case VK_FORMAT_R32G32B32A32_SINT:
+        return NumericType::SInt;
+
+    case VK_FORMAT_UNDEFINED:
+        return NumericType::Unknown;
+
+    default:
+        return NumericType::Float;  // SFLOAT, UNORM, SNORM and SCALED are all read as floats.
+    }
+}
+
+const char* getNumericTypeName(NumericType type)
+{
+    switch (type)
+    {
+    case NumericType::Float: return "float";
+    case NumericType::SInt: return "int";
+    case NumericType::UInt: return "uint";
+    default: return "unknown";
+    }
+}
+
+class Parser
+{
+public:
+    explicit Parser(std::span<const uint32_t> code)
+        : m_code(code)
+    {
+        if (code.size() < k_spirv_header_size || code[0] != k_spirv_magic)
+        {
+            throw std::runtime_error("SPIR-V reflection: not a SPIR-V binary");
+        }
+        // Every id is defined by an instruction of two words or more, so a larger id bound is malformed.
+        m_ids.resize(std::min<size_t>(code[3], code.size()));
+    }
+
+    ShaderReflection parse()
+    {
+        for (size_t i = k_spirv_header_size; i < m_code.size();)
+        {
+            const uint32_t count  = m_code[i] >> 16;
+            const uint32_t opcode = m_code[i] & 0xffff;
+            if (count == 0 || i + count > m_code.size())
+            {
+                throw std::runtime_error("SPIR-V reflection: truncated instruction");
+            }
+            parseInstruction(opcode, m_code.subspan(i + 1, count - 1));
+            i += count;
+        }
+        if (m_stage == 0)
+        {
+            throw std::runtime_error("SPIR-V reflection: no entry point");
+        }
+
+        ShaderReflection reflection;
+        reflection.stages = m_stage;
+        for (const uint32_t variable : m_variables)
+        {
+            addVariable(reflection, variable);
+        }
+
+        std::sort(reflection.bindings.begin(), reflection.bindings.end(), [](const auto& a, const auto& b) {
+            return a.set != b.set ? a.set < b.set : a.layoutBinding.binding < b.layoutBinding.binding;
+        });
+        std::sort(reflection.vertexInputs.begin(), reflection.vertexInputs.end(), [](const auto& a, const auto& b) {
+            return a.location < b.location;
+        });
+        return reflection;
+    }
+
+private:
+    Id& get(uint32_t id)
+    {
+        if (id >= m_ids.size())
+        {
+            throw std::runtime_error("SPIR-V reflection: id out of bounds");
+        }
+        return m_ids[id];
+    }
+
+    static uint32_t operand(const Id& id, size_t i)
+    {
+        if (i >= id.operands.size())
+        {
+            throw std::runtime_error("SPIR-V reflection: truncated instruction");
+        }
+        return id.operands[i];
+    }
+
+    void parseInstruction(uint32_t opcode, std::span<const uint32_t> words)
+    {
+        switch (opcode)
+        {
+        case k_op_entry_point:
+            // Only the first entry point is reflected.
+            if (m_stage == 0 && words.size() >= 2)
+            {
+                m_stage = getStage(words[0]);
+            }
+            break;
+
+        case k_op_type_int:
+        case k_op_type_float:
+        case k_op_type_vector:
+        case k_op_type_matrix:
+        case k_op_type_image:
+        case k_op_type_sampler:
+        case k_op_type_sampled_image:
+        case k_op_type_array:
+        case k_op_type_runtime_array:
+        case k_op_type_struct:
+        case k_op_type_pointer:
+        case k_op_type_accel_struct:
+            if (!words.empty())
+            {
+                Id& id    = get(words[0]);
+                id.opcode = opcode;
+                id.operands.assign(words.begin() + 1, words.end());
+                if (opcode == k_op_type_struct)
+                {
+                    id.members.resize(id.operands.size());
+                }
+            }
+            break;
+
+        case k_op_constant:
+        case k_op_variable:
+            if (words.size() >= 3)
+            {
+                Id& id    = get(words[1]);
+                id.opcode = opcode;
+                id.type   = words[0];
+                id.operands.assign(words.begin() + 2, words.end());
+                if (opcode == k_op_variable)
+                {
+                    m_variables.push_back(words[1]);
+                }
+            }
+            break;
+
+        case k_op_decorate:
+            if (words.size() >= 2)
+            {
+                Id&            id    = get(words[0]);
+                const uint32_t value = words.size() >= 3 ? words[2] : 0;
+                switch (words[1])
+                {
+                case k_decoration_buffer_block: id.bufferBlock = true; break;
+                case k_decoration_array_stride: id.arrayStride = value; break;
+                case k_decoration_built_in: id.builtIn = true; break;
+                case k_decoration_location: id.location = value; break;
+                case k_decoration_binding: id.binding = value; break;
+                case k_decoration_set: id.set = value; break;
+                }
+            }
+            break;
+
+        case k_op_member_decorate:
+            if (words.size() >= 4)
+            {
+                // Member decorations may come before the struct itself.
+                Id& id = get(words[0]);
+                if (id.members.size() <= words[1])
+                {
+                    id.members.resize(words[1] + 1);
+                }
+                switch (words[2])
+                {
+                case k_decoration_offset: id.members[words[1]].offset = words[3]; break;
+                case k_decoration_matrix_stride: id.members[words[1]].matrixStride = words[3]; break;
+                }
+            }
+            break;
+        }
+    }
+
+    uint32_t getConstant(uint32_t id)
+    {
+        const Id& constant = get(id);
+        if (constant.opcode != k_op_constant || constant.operands.empty())
+        {
+            throw std::runtime_error("SPIR-V reflection: array length is not a constant");
+        }
+        return operand(constant, 0);
+    }
+
+    uint32_t getSize(uint32_t typeId, uint32_t matrixStride = 0)
+    {
+        const Id& type = get(typeId);
+        switch (type.opcode)
+        {
+        case k_op_type_int:
+        case k_op_type_float:
+            return operand(type, 0) / 8;
+        case k_op_type_vector:
+            return operand(type, 1) * getSize(operand(type, 0));
+        case k_op_type_matrix:
+            return operand(type, 1) * (matrixStride != 0 ? matrixStride : getSize(operand(type, 0)));
+        case k_op_type_array:
+        {
+            const uint32_t length = getConstant(operand(type, 1));
+            return length * (type.arrayStride != 0 ? type.arrayStride : getSize(operand(type, 0)));
+        }
+        case k_op_type_struct:
+        {
+            uint32_t size = 0;
+            for (size_t i = 0; i < type.operands.size(); ++i)
+            {
+                const Member& member = type.members[i];
+                size                 = std::max(size, member.offset + getSize(operand(type, i), member.matrixStride));
+            }
+            return size;
+        }
+        default:
+            return 0;  // Runtime arrays have no static size.
+        }
+    }
+
+    VkFormat getFormat(uint32_t typeId)
+    {
+        const Id& type = get(typeId);
+
+        uint32_t  components = 1;
+        const Id* scalar     = &type;
+        if (type.opcode == k_op_type_vector)
+        {
+            components = operand(type, 1);
+            scalar     = &get(operand(type, 0));
+        }
+
+        static constexpr VkFormat k_float32[] = {
+            VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT
+        };
+        static constexpr VkFormat k_sint32[] = {
+            VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT
+        };
+        static constexpr VkFormat k_uint32[] = {
+            VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT
+        };
+
+        if (components < 1 || components > 4 || (scalar->opcode != k_op_type_float && scalar->opcode != k_op_type_int) ||
+            operand(*scalar, 0) != 32)
+        {
+            return VK_FORMAT_UNDEFINED;
+        }
+        if (scalar->opcode == k_op_type_float)
+        {
+            return k_float32[components - 1];
+        }
+        if (scalar->opcode == k_op_type_int)
+        {
+            return operand(*scalar, 1) != 0 ? k_sint32[components - 1] : k_uint32[components - 1];
+        }
+        return VK_FORMAT_UNDEFINED;
+    }
+
+    void addVariable(ShaderReflection& reflection, uint32_t variableId)
+    {
+        const Id&      variable     = get(variableId);
+        const uint32_t storageClass = operand(variable, 0);
+        const Id&      pointer      = get(variable.type);
+        if (pointer.opcode != k_op_type_pointer)
+        {
+            return;
+        }
+        uint32_t typeId = operand(pointer, 1);
+
+        switch (storageClass)
+        {
+        case k_storage_input:
+            if (m_stage == VK_SHADER_STAGE_VERTEX_BIT && !variable.builtIn && variable.location != k_invalid)
+            {
+                // A matrix takes one location per column.
+                const Id&      type    = get(typeId);
+                const bool     matrix  = type.opcode == k_op_type_matrix;
+                const uint32_t columns = matrix ? operand(type, 1) : 1;
+                const VkFormat format  = getFormat(matrix ? operand(type, 0) : typeId);
+                for (uint32_t i = 0; i < columns; ++i)
+                {
+                    reflection.vertexInputs.push_back({ variable.location + i, format });
+                }
+            }
+            return;
+
+        case k_storage_push_constant:
+        {
+            const Id& type   = get(typeId);
+            uint32_t  offset = k_invalid;
+            for (const Member& member : type.members)
+            {
+                offset = std::min(offset, member.offset);
+            }
+            offset = offset == k_invalid ? 0 : offset;
+            reflection.pushConstantRanges.push_back({ m_stage, offset, getSize(typeId) - offset });
+            return;
+        }
+
+        case k_storage_uniform_constant:
+        case k_storage_uniform:
+        case k_storage_storage_buffer:
+            break;
+
+        default:
+            return;
+        }
+
+        if (variable.binding == k_invalid)
+        {
+            return;
+        }
+
+        uint32_t count = 1;
+        for (;;)
+        {
+            const Id& type = get(typeId);
+            if (type.opcode == k_op_type_array)
+            {
+                count *= getConstant(operand(type, 1));
+            }
+            else if (type.opcode != k_op_type_runtime_array)
+            {
+                break;
+            }
+            typeId = operand(type, 0);
+        }
+
+        const Id&        type           = get(typeId);
+        VkDescriptorType descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        if (storageClass == k_storage_storage_buffer || (storageClass == k_storage_uniform && type.bufferBlock))
+        {
+            descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        }
+        else if (storageClass == k_storage_uniform_constant)
+        {
+            switch (type.opcode)
+            {
+            case k_op_type_sampler:
+                descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+                break;
+            case k_op_type_sampled_image:
+                descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                break;
+            case k_op_type_image:
+            {
+                const uint32_t dim     = operand(type, 1);
+                const bool     storage = operand(type, 5) == 2;
+                if (dim == k_dim_buffer)
+                {
+                    descriptorType = storage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+                }
+                else if (dim == k_dim_subpass_data)
+                {
+                    descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                }
+                else
+                {
+                    descriptorType = storage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+                }
+                break;
+            }
+            case k_op_type_accel_struct:
+                descriptorType = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+                break;
+            default:
+                return;
+            }
+        }
+
+        ShaderReflection::Binding binding;
+        binding.set                           = variable.set;
+        binding.layoutBinding.binding         = variable.binding;
+        binding.layoutBinding.descriptorType  = descriptorType;
+        binding.layoutBinding.descriptorCount = count;
+        binding.layoutBinding.stageFlags      = m_stage;
+        reflection.bindings.push_back(binding);
+    }
+
+    std::span<const uint32_t> m_code;
+    std::vector<Id>           m_ids;
+    std::vector<uint32_t>     m_variables;
+    VkShaderStageFlagBits     m_stage = VkShaderStageFlagBits(0);
+};
+
+}  // namespace
+
+void ShaderReflection::merge(const ShaderReflection& other)
+{
+    for (const Binding& binding : other.bindings)
+    {
+        auto it = std::find_if(bindings.begin(), bindings.end(), [&](const Binding& b) {
+            return b.set == binding.set && b.layoutBinding.binding == binding.layoutBinding.binding;
+        });
+        if (it == bindings.end())
+        {
+            bindings.push_back(binding);
+            continue;
+        }
+        if (it->layoutBinding.descriptorType != binding.layoutBinding.descriptorType ||
+            it->layoutBinding.descriptorCount != binding.layoutBinding.descriptorCount)
+        {
+            throw std::runtime_error("SPIR-V reflection: set " + std::to_string(binding.set) + " binding " +
+                                     std::to_string(binding.layoutBinding.binding) + " is declared differently by two stages");
+        }
+        it->layoutBinding.stageFlags |= binding.layoutBinding.stageFlags;
+    }
+    std::sort(bindings.begin(), bindings.end(), [](const Binding& a, const Binding& b) {
+        return a.set != b.set ? a.set < b.set : a.layoutBinding.binding < b.layoutBinding.binding;
+    });
+
+    for (const VkPushConstantRange& range : other.pushConstantRanges)
+    {
+        auto it = std::find_if(pushConstantRanges.begin(), pushConstantRanges.end(), [&](const VkPushConstantRange& r) {
+            return r.offset == range.offset && r.size == range.size;
+        });
+        if (it != pushConstantRanges.end())
+        {
+            it->stageFlags |= range.stageFlags;
+        }
+        else
+        {
+            pushConstantRanges.push_back(range);
+        }
+    }
+
+    if (vertexInputs.empty())
+    {
+        vertexInputs = other.vertexInputs;
+    }
+    stages |= other.stages;
+}
+
+std::vector<VkDescriptorSetLayoutBinding> ShaderReflection::getSetLayoutBindings(uint32_t set) const
+{
+    std::vector<VkDescriptorSetLayoutBinding> layoutBindings;
+    for (const Binding& binding : bindings)
+    {
+        if (binding.set == set)
+        {
+            layoutBindings.push_back(binding.layoutBinding);
+        }
+    }
+    return layoutBindings;
+}
+
+void ShaderReflection::validateVertexInput(std::span<const VkVertexInputAttributeDescription> attributes) const
+{
+    for (const VertexInput& input : vertexInputs)
+    {
+        auto it = std::find_if(attributes.begin(), attributes.end(), [&](const VkVertexInputAttributeDescription& attribute) {
+            return attribute.location == input.location;
+        });
+        if (it == attributes.end())
+        {
+            throw std::runtime_error("SPIR-V reflection: no vertex attribute for input location " + std::to_string(input.location));
+        }
+
+        const NumericType expected = getNumericType(input.format);
+        const NumericType provided = getNumericType(it->format);
+        if (expected != NumericType::Unknown && expected != provided)
+        {
+            throw std::runtime_error("SPIR-V reflection: vertex input location " + std::to_string(input.location) + " expects " +
+                                     getNumericTypeName(expected) + " data, the attribute provides " + getNumericTypeName(provided));
+        }
+    }
+}
+
+ShaderReflection reflectShader(std::span<const uint32_t> code)
+{
+    return Parser(code).parse();
+}
+
+}  // namespace vulkan
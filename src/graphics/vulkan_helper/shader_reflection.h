@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "graphics/vulkan_helper/descriptorsets_helper.h"
+
+namespace vulkan
+{
+
+//--------------------------------------------------------------------------------------------------
+/**
+  \class vulkan::ShaderReflection
+
+  vulkan::ShaderReflection lists the resources a SPIR-V binary declares: descriptor bindings per set, push
+  constant ranges and, for vertex shaders, the input locations with the format matching their GLSL type. It is
+  filled by `reflectShader()`, which walks the binary once without any external dependency. Stages are combined
+  with `merge()`, which also catches bindings declared differently by two stages.
+
+  The descriptor type comes from the declaration, so dynamic uniform or storage buffers must be patched by the
+  caller. Runtime arrays are reported with a count of 1.
+
+  Errors (invalid binary, conflicting stages, missing vertex attribute) throw std::runtime_error: they are
+  meant to be caught when shaders are loaded, not while drawing.
+
+  Example of usage :
+  \code{.cpp}
+  vulkan::ShaderReflection reflection = vulkan::reflectShader(vertCode);
+  reflection.merge(vulkan::reflectShader(fragCode));
+  reflection.validateVertexInput(attributeDescriptions);
+
+  vulkan::DescriptorSetBindings bindings = reflection.makeDescriptorSetBindings(0);
+  \endcode
+*/
+
+struct ShaderReflection
+{
+    struct Binding
+    {
+        uint32_t                     set = 0;
+        VkDescriptorSetLayoutBinding layoutBinding{};
+    };
+
+    struct VertexInput
+    {
+        uint32_t location = 0;
+        VkFormat format   = VK_FORMAT_UNDEFINED;
+    };
+
+    VkShaderStageFlags               stages = 0;
+    std::vector<Binding>             bindings;  // Sorted by set, then binding.
+    std::vector<VkPushConstantRange> pushConstantRanges;
+    std::vector<VertexInput>         vertexInputs;  // Sorted by location. Built-ins are not listed.
+
+    // Adds the resources of other stages. Bindings used by both get the union of the stage flags.
+    void merge(const ShaderReflection& other);
+
+    std::vector<VkDescriptorSetLayoutBinding> getSetLayoutBindings(uint32_t set) const;
+    DescriptorSetBindings                     makeDescriptorSetBindings(uint32_t set) const { return getSetLayoutBindings(set); }
+
+    // Checks that every vertex input is fed by an attribute of the same numeric type: float (including normalized and
+    // scaled formats), signed or unsigned integer.
+    void validateVertexInput(std::span<const VkVertexInputAttributeDescription> attributes) const;
+};
+
+ShaderReflection reflectShader(std::span<const uint32_t> code);
+
+}  // namespace vulkan
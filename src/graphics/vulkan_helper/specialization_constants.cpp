@@ -0,0 +1,52 @@
+#include "graphics/vulkan_helper/specialization_constants.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "utils/hash.h"
+
+namespace vulkan
+{
+
+uint64_t SpecializationConstants::hash() const
+{
+    Hasher hasher;
+    for (const VkSpecializationMapEntry& entry : m_entries)
+    {
+        hasher.add(entry.constantID).add(std::span<const uint8_t>(m_data.data() + entry.offset, entry.size));
+    }
+    return hasher.get();
+}
+
+const VkSpecializationInfo* SpecializationConstants::getInfo()
+{
+    m_info.mapEntryCount = static_cast<uint32_t>(m_entries.size());
+    m_info.pMapEntries   = m_entries.data();
+    m_info.dataSize      = m_data.size();
+    m_info.pData         = m_data.data();
+    return &m_info;
+}
+
+void SpecializationConstants::setBytes(uint32_t id, const void* data, uint32_t size)
+{
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), id, [](const VkSpecializationMapEntry& entry, uint32_t id) {
+        return entry.constantID < id;
+    });
+    if (it != m_entries.end() && it->constantID == id)
+    {
+        assert(it->size == size && "Specialization constant set with another type");
+        std::memcpy(m_data.data() + it->offset, data, size);
+        return;
+    }
+
+    VkSpecializationMapEntry entry;
+    entry.constantID = id;
+    entry.offset     = static_cast<uint32_t>(m_data.size());
+    entry.size       = size;
+    m_entries.insert(it, entry);
+
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    m_data.insert(m_data.end(), bytes, bytes + size);
+}
+
+}  // namespace vulkan
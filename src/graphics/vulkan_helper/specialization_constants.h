@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace vulkan
+{
+
+//--------------------------------------------------------------------------------------------------
+/**
+  \struct vulkan::SpecializationConstant
+
+  Typed identifier of a `layout(constant_id = N) const T name = ...;` declared by a shader. Declare them once as
+  constexpr next to the code using the shader, so a value of the wrong type does not compile. bool maps to VkBool32;
+  other scalar types must be 32 or 64 bits wide, like their GLSL counterparts.
+
+  \class vulkan::SpecializationConstants
+
+  vulkan::SpecializationConstants holds the values of the specialization constants of one shader stage and the
+  VkSpecializationInfo pointing to them. It is a plain value: copies own their data, and `hash()` only depends on
+  the ids and values, in whatever order they were set.
+
+  Example of usage :
+  \code{.cpp}
+  constexpr vulkan::SpecializationConstant<bool>     k_lighting{ 0 };
+  constexpr vulkan::SpecializationConstant<uint32_t> k_texture_count{ 1 };
+
+  vulkan::SpecializationConstants constants;
+  constants.set(k_lighting, true).set(k_texture_count, 2u);
+  pipelineGenerator.setSpecialization(VK_SHADER_STAGE_FRAGMENT_BIT, constants);
+  \endcode
+*/
+
+template <typename T>
+struct SpecializationConstant
+{
+    static_assert(std::is_same_v<T, bool> || (std::is_arithmetic_v<T> && (sizeof(T) == 4 || sizeof(T) == 8)),
+                  "Specialization constants are bool or 32/64-bit scalars");
+
+    uint32_t id = 0;
+};
+
+class SpecializationConstants
+{
+public:
+    template <typename T>
+    SpecializationConstants& set(SpecializationConstant<T> constant, T value)
+    {
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            const VkBool32 data = value ? VK_TRUE : VK_FALSE;
+            setBytes(constant.id, &data, sizeof(data));
+        }
+        else
+        {
+            setBytes(constant.id, &value, sizeof(value));
+        }
+        return *this;
+    }
+
+    bool empty() const { return m_entries.empty(); }
+    void clear()
+    {
+        m_entries.clear();
+        m_data.clear();
+    }
+
+    uint64_t hash() const;
+
+    // Points to this object's data: valid until it is modified, moved or destroyed.
+    const VkSpecializationInfo* getInfo();
+
+private:
+    void setBytes(uint32_t id, const void* data, uint32_t size);
+
+    std::vector<VkSpecializationMapEntry> m_entries;  // Sorted by constantID.
+    std::vector<uint8_t>                  m_data;
+    VkSpecializationInfo                  m_info{};
+};
+
+}  // namespace vulkan
@@ -0,0 +1,47 @@
+// Limits of mesh::buildMeshlets(), sized for mesh shader workgroups: 124 triangles keep the micro-indices of a full
+// meshlet a multiple of 4 bytes.
+#define MESHLET_MAX_VERTICES  64
+#define MESHLET_MAX_TRIANGLES 124
+
+#ifndef __cplusplus
+// mesh::Meshlet. Vertex i of the meshlet is meshlet_vertices[vertex_offset + i], triangle t its micro-indices at bytes
+// triangle_offset + 3 * t to triangle_offset + 3 * t + 2 of meshlet_triangles.
+struct Meshlet
+{
+    uint vertex_offset;
+    uint triangle_offset;
+    uint vertex_count;
+    uint triangle_count;
+};
+
+// mesh::MeshletBounds.
+struct MeshletBounds
+{
+    vec3  center;
+    float radius;
+    vec3  cone_apex;
+    float cone_cutoff;
+    vec3  cone_axis;
+    float padding;
+};
+
+// True when every triangle of the meshlet is seen from behind by a camera at `camera_position`.
+bool isMeshletBackfacing(MeshletBounds bounds, vec3 camera_position)
+{
+    vec3 view = bounds.cone_apex - camera_position;
+    return dot(view, bounds.cone_axis) > bounds.cone_cutoff * length(view);
+}
+
+// `planes` are normalized and point inside the frustum.
+bool isMeshletOutside(MeshletBounds bounds, vec4 planes[6])
+{
+    for (int i = 0; i < 6; ++i)
+    {
+        if (dot(planes[i].xyz, bounds.center) + planes[i].w < -bounds.radius)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+#endif  // __cplusplus
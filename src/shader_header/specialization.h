@@ -0,0 +1 @@
+#define SPEC_ID_UV_COLOR 0
@@ -0,0 +1,25 @@
+#ifndef __cplusplus
+// GLSL side of graphics/vertex_packing.h: the vertex fetch already turns the formats into floats, only the encodings
+// need rebuilding.
+
+// Input of vertex::AttributeType::NormalOct.
+vec3 decodeOctahedral(vec2 e)
+{
+    vec3  n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
+// `tangent` is the input of vertex::AttributeType::TangentPacked, w holding the handedness.
+vec3 decodeBitangent(vec3 normal, vec4 tangent)
+{
+    return cross(normal, tangent.xyz) * (tangent.w < 0.0 ? -1.0 : 1.0);
+}
+
+// Inputs of vertex::AttributeType::InstanceRow0 to InstanceRow2.
+mat4 decodeInstanceTransform(vec4 row0, vec4 row1, vec4 row2)
+{
+    return transpose(mat4(row0, row1, row2, vec4(0.0, 0.0, 0.0, 1.0)));
+}
+#endif  // __cplusplus
@@ -0,0 +1,22 @@
+#include "utils/embedded_shaders.h"
+#include <algorithm>
+
+// Generated by the "shader.embed" rule: includes every shader header and defines k_embedded_shaders, sorted by name.
+#if defined(EMBED_SHADERS)
+#include "embedded_shaders.inl"
+#endif
+
+std::span<const uint32_t> findEmbeddedShader(std::string_view name)
+{
+#if defined(EMBED_SHADERS)
+    const auto* end = std::end(k_embedded_shaders);
+    const auto* it  = std::lower_bound(std::begin(k_embedded_shaders), end, name, [](const EmbeddedShader& shader, std::string_view name) {
+        return shader.name < name;
+    });
+    if (it != end && it->name == name)
+    {
+        return it->code;
+    }
+#endif
+    return {};
+}
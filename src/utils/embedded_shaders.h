@@ -0,0 +1,14 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+// SPIR-V compiled into the executable by the "shader.embed" rule of xmake.lua, one entry per shader/src/*.glsl.
+struct EmbeddedShader
+{
+    std::string_view          name;  // Name of the binary in the shader search path, e.g. "test.vert.spv".
+    std::span<const uint32_t> code;
+};
+
+// Returns the embedded SPIR-V named `name`, pointing into the executable image, or an empty span.
+std::span<const uint32_t> findEmbeddedShader(std::string_view name);
@@ -0,0 +1,138 @@
+#include "utils/file_watcher.h"
+#include <algorithm>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+
+FileWatcher::FileWatcher() noexcept
+    : m_inotify_fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+{}
+
+FileWatcher::~FileWatcher() noexcept
+{
+    if (m_inotify_fd >= 0)
+    {
+        close(m_inotify_fd);
+    }
+}
+
+bool FileWatcher::addDirectory(const std::filesystem::path& dir)
+{
+    if (m_inotify_fd < 0 || !std::filesystem::is_directory(dir))
+    {
+        return false;
+    }
+
+    // Editors often save through a temporary file renamed over the original: IN_MOVED_TO covers that case.
+    const int wd = inotify_add_watch(m_inotify_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd < 0)
+    {
+        return false;
+    }
+    m_watch_dirs[wd] = dir;
+    return true;
+}
+
+std::vector<std::filesystem::path> FileWatcher::poll()
+{
+    std::vector<std::filesystem::path> changed;
+    if (m_inotify_fd < 0)
+    {
+        return changed;
+    }
+
+    alignas(inotify_event) char buffer[4096];
+    for (;;)
+    {
+        const ssize_t length = read(m_inotify_fd, buffer, sizeof(buffer));
+        if (length <= 0)
+        {
+            break;  // EAGAIN: nothing left to read.
+        }
+
+        for (ssize_t offset = 0; offset < length;)
+        {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += sizeof(inotify_event) + event->len;
+
+            auto it = m_watch_dirs.find(event->wd);
+            if (it == m_watch_dirs.end() || event->len == 0 || (event->mask & IN_ISDIR))
+            {
+                continue;
+            }
+
+            std::filesystem::path path = it->second / event->name;
+            if (std::find(changed.begin(), changed.end(), path) == changed.end())
+            {
+                changed.push_back(std::move(path));
+            }
+        }
+    }
+    return changed;
+}
+
+#else
+
+FileWatcher::FileWatcher() noexcept
+    : m_last_scan(std::chrono::steady_clock::now())
+{}
+
+FileWatcher::~FileWatcher() noexcept {}
+
+bool FileWatcher::addDirectory(const std::filesystem::path& dir)
+{
+    std::error_code ec;
+    if (!std::filesystem::is_directory(dir, ec))
+    {
+        return false;
+    }
+
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec))
+    {
+        if (entry.is_regular_file(ec))
+        {
+            m_write_times[entry.path().string()] = entry.last_write_time(ec);
+        }
+    }
+    m_dirs.push_back(dir);
+    return true;
+}
+
+std::vector<std::filesystem::path> FileWatcher::poll()
+{
+    std::vector<std::filesystem::path> changed;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now - m_last_scan < k_scan_interval)
+    {
+        return changed;
+    }
+    m_last_scan = now;
+
+    std::error_code ec;
+    for (const std::filesystem::path& dir : m_dirs)
+    {
+        for (const auto& entry : std::filesystem::directory_iterator(dir, ec))
+        {
+            if (!entry.is_regular_file(ec))
+            {
+                continue;
+            }
+
+            const std::filesystem::file_time_type write_time = entry.last_write_time(ec);
+            auto [it, inserted] = m_write_times.try_emplace(entry.path().string(), write_time);
+            if (inserted || it->second != write_time)
+            {
+                it->second = write_time;
+                changed.push_back(entry.path());
+            }
+        }
+    }
+    return changed;
+}
+
+#endif
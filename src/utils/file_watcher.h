@@ -0,0 +1,36 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Reports the files created or modified in a set of directories (not recursive). Uses inotify on Linux; elsewhere
+// the directories are rescanned for newer write times, at most once per `k_scan_interval`.
+class FileWatcher
+{
+public:
+    static constexpr std::chrono::milliseconds k_scan_interval{ 500 };
+
+public:
+    FileWatcher() noexcept;
+    FileWatcher(const FileWatcher&)            = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+    ~FileWatcher() noexcept;
+
+    // Returns false if the directory does not exist or cannot be watched.
+    bool addDirectory(const std::filesystem::path& dir);
+
+    // Files changed since the last call, each reported once. Never blocks.
+    std::vector<std::filesystem::path> poll();
+
+private:
+#if defined(__linux__)
+    int                                            m_inotify_fd = -1;
+    std::unordered_map<int, std::filesystem::path> m_watch_dirs;  // By inotify watch descriptor.
+#else
+    std::vector<std::filesystem::path>                               m_dirs;
+    std::unordered_map<std::string, std::filesystem::file_time_type> m_write_times;
+    std::chrono::steady_clock::time_point                            m_last_scan;
+#endif
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+// 64-bit FNV-1a, stable across runs and platforms so the results can be stored on disk.
+inline constexpr uint64_t k_hash_seed  = 0xcbf29ce484222325ull;
+inline constexpr uint64_t k_hash_prime = 0x00000100000001b3ull;
+
+inline uint64_t hashBytes(const void* data, size_t size, uint64_t seed = k_hash_seed) noexcept
+{
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    uint64_t    hash  = seed;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= k_hash_prime;
+    }
+    return hash;
+}
+
+inline uint64_t hashCombine(uint64_t seed, uint64_t value) noexcept
+{
+    return hashBytes(&value, sizeof(value), seed);
+}
+
+// Accumulates values field by field. Only feed it scalars or tightly packed PODs: padding bytes are not stable.
+class Hasher
+{
+public:
+    explicit Hasher(uint64_t seed = k_hash_seed) noexcept
+        : m_hash(seed)
+    {}
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    Hasher& add(const T& value) noexcept
+    {
+        m_hash = hashBytes(&value, sizeof(T), m_hash);
+        return *this;
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    Hasher& add(std::span<const T> values) noexcept
+    {
+        add(values.size());
+        m_hash = hashBytes(values.data(), values.size_bytes(), m_hash);
+        return *this;
+    }
+
+    Hasher& add(std::string_view str) noexcept
+    {
+        add(str.size());
+        m_hash = hashBytes(str.data(), str.size(), m_hash);
+        return *this;
+    }
+
+    Hasher& add(const char* str) noexcept { return add(std::string_view(str ? str : "")); }
+
+    uint64_t get() const noexcept { return m_hash; }
+
+private:
+    uint64_t m_hash;
+};
@@ -18,14 +18,13 @@ inline void setShaderSearchPath(const std::string& path)
     search_path       = path;
 }
 
-inline std::vector<char> loadShaderCode(const char* path)
+// Reads a binary whose path is already resolved against the search path.
+inline std::vector<char> readShaderFile(const std::string& file_path)
 {
-    std::string file_path = getFilePathString(path, { getShaderSearchPath() });
-
     std::ifstream file(file_path, std::ios::ate | std::ios::binary);
     if (!file.is_open())
     {
-        throw std::runtime_error(std::string("Failed to open file at path = ") + std::string(path));
+        throw std::runtime_error(std::string("Failed to open file at path = ") + file_path);
     }
 
     size_t            file_size = (size_t)file.tellg();
@@ -36,3 +35,13 @@ inline std::vector<char> loadShaderCode(const char* path)
 
     return buffer;
 }
+
+inline std::vector<char> loadShaderCode(const char* path)
+{
+    std::string file_path = getFilePathString(path, { getShaderSearchPath() });
+    if (file_path.empty())
+    {
+        throw std::runtime_error(std::string("Failed to open file at path = ") + std::string(path));
+    }
+    return readShaderFile(file_path);
+}
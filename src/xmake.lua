@@ -42,19 +42,36 @@ add_includedirs("./")
 add_files(
     "./core/*.cpp",
     "./extern_impl/*.cpp",
-    "./graphics/*.cpp",
+    "./graphics/*.cpp|vertex_convert_*.cpp",
     "./graphics/bindable/*.cpp",
     "./graphics/drawable/*.cpp",
+    "./graphics/mesh/*.cpp",
     "./graphics/resource/*.cpp",
     "./graphics/vulkan_helper/*.cpp",
     "./utils/*.cpp"
 )
+-- Vertex conversion kernels: each file is built for its instruction set, and only runs on CPUs that have it.
+if not is_arch("x64", "x86_64") then
+    add_files("./graphics/vertex_convert_sse41.cpp", "./graphics/vertex_convert_avx2.cpp")
+elseif has_config("is_msvc") and not has_config("is_clang") then
+    add_files("./graphics/vertex_convert_sse41.cpp")
+    add_files("./graphics/vertex_convert_avx2.cpp", {cxflags = "/arch:AVX2"})
+elseif has_config("is_msvc") then
+    add_files("./graphics/vertex_convert_sse41.cpp", {cxflags = "/clang:-msse4.1"})
+    add_files("./graphics/vertex_convert_avx2.cpp", {cxflags = "/arch:AVX2"})
+else
+    add_files("./graphics/vertex_convert_sse41.cpp", {cxflags = "-msse4.1"})
+    add_files("./graphics/vertex_convert_avx2.cpp", {cxflags = "-mavx2"})
+end
+add_rules("shader.embed")
+add_files("../shader/src/*.glsl")
 add_headerfiles(
     "./core/*.h",
     "./shader_header/*.h",
     "./graphics/*.h",
     "./graphics/bindable/*.h",
     "./graphics/drawable/*.h",
+    "./graphics/mesh/*.h",
     "./graphics/resource/*.h",
     "./graphics/vulkan_helper/*.h",
     "./utils/*.h"
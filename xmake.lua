@@ -123,4 +123,121 @@ function BuildProject(config)
     end
 end
 
+--[[
+    Compiles shader/src/<name>.<stage>.glsl with glslangValidator, optimized with spirv-opt in release, into
+    shader/bin/<name>.<stage>.spv, where the shader hot reload looks for it, and embeds the SPIR-V into the
+    executable: every shader becomes a header holding an aligned constexpr uint32_t array, and
+    embedded_shaders.inl lists them for src/utils/embedded_shaders.cpp.
+]]
+rule("shader.embed")
+    set_extensions(".glsl")
+
+    on_config(function (target)
+        local sourcebatch = target:sourcebatches()["shader.embed"]
+        if sourcebatch == nil or #sourcebatch.sourcefiles == 0 then
+            return
+        end
+
+        local names = {}
+        for _, sourcefile in ipairs(sourcebatch.sourcefiles) do
+            table.insert(names, path.basename(sourcefile))
+        end
+        table.sort(names)
+
+        local lines = {"#pragma once"}
+        for _, name in ipairs(names) do
+            table.insert(lines, format('#include "%s.spv.h"', name))
+        end
+        table.insert(lines, "")
+        table.insert(lines, "// Sorted by name for findEmbeddedShader().")
+        table.insert(lines, "inline constexpr EmbeddedShader k_embedded_shaders[] = {")
+        for _, name in ipairs(names) do
+            table.insert(lines, format('    { "%s.spv", k_spv_%s },', name, (name:gsub("[^%w]", "_"))))
+        end
+        table.insert(lines, "};")
+
+        -- Rewritten only when the list changes, so embedded_shaders.cpp is not rebuilt for nothing.
+        local gendir   = path.join(target:autogendir(), "shaders")
+        local listfile = path.join(gendir, "embedded_shaders.inl")
+        local content  = table.concat(lines, "\n") .. "\n"
+        if not os.isfile(listfile) or io.readfile(listfile) ~= content then
+            io.writefile(listfile, content)
+        end
+
+        target:add("includedirs", gendir)
+        target:add("defines", "EMBED_SHADERS")
+    end)
+
+    -- Each shader is its own build job. It is rebuilt when the source, one of the headers it includes (listed by
+    -- glslang's depfile), the build mode or the command line changes.
+    before_build_file(function (target, sourcefile, opt)
+        import("core.base.option")
+        import("core.project.depend")
+        import("lib.detect.find_tool")
+        import("utils.progress")
+
+        local name       = path.basename(sourcefile)
+        local stage      = path.extension(name):sub(2)
+        local spvfile    = path.join(os.projectdir(), "shader", "bin", name .. ".spv")
+        local headerfile = path.join(target:autogendir(), "shaders", name .. ".spv.h")
+        local depfile    = headerfile .. ".d"
+        local dependfile = target:dependfile(headerfile)
+
+        local args = {"-V", "-S", stage, "-I" .. path.join(os.projectdir(), "src", "shader_header")}
+        local optimize = is_mode("release")
+
+        local dependinfo = option.get("rebuild") and {} or (depend.load(dependfile) or {})
+        if os.isfile(headerfile) and not depend.is_changed(dependinfo, {lastmtime = os.mtime(headerfile), values = {args, optimize}}) then
+            return
+        end
+
+        local glslang = assert(find_tool("glslangValidator"), "glslangValidator not found, install the Vulkan SDK")
+        progress.show(opt.progress, "${color.build.object}compiling.shader %s", sourcefile)
+
+        os.mkdir(path.directory(spvfile))
+        os.mkdir(path.directory(headerfile))
+        os.vrunv(glslang.program, table.join(args, {"--depfile", depfile, "-o", spvfile, sourcefile}))
+
+        -- Performance passes only: debug builds keep the SPIR-V close to the source for shader debuggers.
+        if optimize then
+            local spirvopt = assert(find_tool("spirv-opt"), "spirv-opt not found, install the Vulkan SDK")
+            os.vrunv(spirvopt.program, {"-O", spvfile, "-o", spvfile})
+        end
+
+        local bytes = io.readfile(spvfile, {encoding = "binary"})
+        local words = {}
+        for i = 1, #bytes, 4 do
+            local b1, b2, b3, b4 = bytes:byte(i, i + 3)
+            table.insert(words, format("0x%08x", b1 + b2 * 0x100 + b3 * 0x10000 + b4 * 0x1000000))
+        end
+        local lines = {}
+        for i = 1, #words, 8 do
+            table.insert(lines, "    " .. table.concat(words, ", ", i, math.min(i + 7, #words)) .. ",")
+        end
+
+        io.writefile(headerfile, format([[
+// Generated from %s, do not edit.
+#pragma once
+#include <cstdint>
+
+alignas(16) inline constexpr uint32_t k_spv_%s[] = {
+%s
+};
+]], path.filename(sourcefile), (name:gsub("[^%w]", "_")), table.concat(lines, "\n")))
+
+        -- Makefile syntax: "<spv>: <source> <includes>...". The first ": " skips drive letters.
+        local files = {sourcefile}
+        if os.isfile(depfile) then
+            local deps = io.readfile(depfile):gsub("\\\r?\n", " ")
+            local _, colon = deps:find(":%s")
+            for file in (colon and deps:sub(colon + 1) or ""):gmatch("%S+") do
+                table.insert(files, file)
+            end
+        end
+        dependinfo.files  = files
+        dependinfo.values = {args, optimize}
+        depend.save(dependinfo, dependfile)
+    end)
+rule_end()
+
 includes("src")